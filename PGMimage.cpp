@@ -100,23 +100,38 @@ void PGMImage::setPixelValue(int x, int y, int value) {
 }
 
 PGMImage* PGMImage::crearImagenVacia() const {
+    return crearImagenVacia(width, height);
+}
+
+PGMImage* PGMImage::crearImagenVacia(int nuevo_ancho, int nuevo_alto) const {
     PGMImage* nueva = new PGMImage();
     strcpy(nueva->magic, magic);
-    nueva->width = width;
-    nueva->height = height;
+    nueva->width = nuevo_ancho;
+    nueva->height = nuevo_alto;
     nueva->max_color = max_color;
-    nueva->pixel_count = pixel_count;
+    nueva->pixel_count = nuevo_ancho * nuevo_alto;
     
-    nueva->pixels = (int*)malloc(pixel_count * sizeof(int));
+    nueva->pixels = (int*)malloc(nueva->pixel_count * sizeof(int));
     if (nueva->pixels == nullptr) {
         delete nueva;
         return nullptr;
     }
     
     // Inicializar con ceros
-    for (int i = 0; i < pixel_count; i++) {
+    for (int i = 0; i < nueva->pixel_count; i++) {
         nueva->pixels[i] = 0;
     }
     
+    return nueva;
+}
+
+PGMImage* PGMImage::crearImagenConPixeles(int* nuevos_pixeles) const {
+    PGMImage* nueva = new PGMImage();
+    strcpy(nueva->magic, magic);
+    nueva->width = width;
+    nueva->height = height;
+    nueva->max_color = max_color;
+    nueva->pixel_count = width * height;
+    nueva->pixels = nuevos_pixeles;
     return nueva;
 }
\ No newline at end of file
@@ -18,6 +18,13 @@ public:
     
     // Crear una nueva imagen PGM con las mismas dimensiones
     PGMImage* crearImagenVacia() const;
+    
+    // Crear una nueva imagen PGM vacía con otras dimensiones
+    PGMImage* crearImagenVacia(int nuevo_ancho, int nuevo_alto) const;
+    
+    // Crear una imagen PGM con las mismas dimensiones sobre un buffer ya reservado (malloc,
+    // sin inicializar); la imagen pasa a ser su dueña. Permite colocar el buffer antes de crearla
+    PGMImage* crearImagenConPixeles(int* nuevos_pixeles) const;
 };
 
 #endif
\ No newline at end of file
@@ -133,27 +133,42 @@ int PPMImage::getBlue(int x, int y) const {
 }
 
 PPMImage* PPMImage::crearImagenVacia() const {
+    return crearImagenVacia(width, height);
+}
+
+PPMImage* PPMImage::crearImagenVacia(int nuevo_ancho, int nuevo_alto) const {
     PPMImage* nueva = new PPMImage();
     strcpy(nueva->magic, magic);
-    nueva->width = width;
-    nueva->height = height;
+    nueva->width = nuevo_ancho;
+    nueva->height = nuevo_alto;
     nueva->max_color = max_color;
-    nueva->pixel_count = pixel_count;
+    nueva->pixel_count = nuevo_ancho * nuevo_alto * 3;
     
-    nueva->pixels = (int*)malloc(pixel_count * sizeof(int));
+    nueva->pixels = (int*)malloc(nueva->pixel_count * sizeof(int));
     if (nueva->pixels == nullptr) {
         delete nueva;
         return nullptr;
     }
     
     // Inicializar con ceros
-    for (int i = 0; i < pixel_count; i++) {
+    for (int i = 0; i < nueva->pixel_count; i++) {
         nueva->pixels[i] = 0;
     }
     
     return nueva;
 }
 
+PPMImage* PPMImage::crearImagenConPixeles(int* nuevos_pixeles) const {
+    PPMImage* nueva = new PPMImage();
+    strcpy(nueva->magic, magic);
+    nueva->width = width;
+    nueva->height = height;
+    nueva->max_color = max_color;
+    nueva->pixel_count = width * height * 3;
+    nueva->pixels = nuevos_pixeles;
+    return nueva;
+}
+
 int PPMImage::getColorIndex(int x, int y, int component) const {
     return (y * width + x) * 3 + component;
 }
\ No newline at end of file
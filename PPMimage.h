@@ -32,6 +32,13 @@ public:
     // Crear una nueva imagen PPM con las mismas dimensiones
     PPMImage* crearImagenVacia() const;
     
+    // Crear una nueva imagen PPM vacía con otras dimensiones
+    PPMImage* crearImagenVacia(int nuevo_ancho, int nuevo_alto) const;
+    
+    // Crear una imagen PPM con las mismas dimensiones sobre un buffer ya reservado (malloc,
+    // sin inicializar); la imagen pasa a ser su dueña. Permite colocar el buffer antes de crearla
+    PPMImage* crearImagenConPixeles(int* nuevos_pixeles) const;
+    
 private:
     // Obtener índice para componente específica (r=0, g=1, b=2)
     int getColorIndex(int x, int y, int component) const;
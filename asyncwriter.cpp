@@ -0,0 +1,100 @@
+#include "asyncwriter.h"
+#include "timer.h"
+#include <iostream>
+
+AsyncWriter::AsyncWriter(int num_hilos) : en_curso(0), terminar(false), tiempo_escritura_ms(0.0) {
+    if (num_hilos < 1) {
+        num_hilos = 1;
+    }
+    for (int i = 0; i < num_hilos; i++) {
+        hilos.push_back(std::thread(&AsyncWriter::bucleEscritor, this));
+    }
+}
+
+AsyncWriter::~AsyncWriter() {
+    esperar();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminar = true;
+    }
+    cond_tarea.notify_all();
+    for (size_t i = 0; i < hilos.size(); i++) {
+        hilos[i].join();
+    }
+}
+
+void AsyncWriter::encolar(Imagen* imagen, const std::string& ruta, const Devolucion& devolver) {
+    Tarea tarea;
+    tarea.imagen = imagen;
+    tarea.ruta = ruta;
+    tarea.devolver = devolver;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cola.push_back(tarea);
+    }
+    cond_tarea.notify_one();
+}
+
+bool AsyncWriter::esperar() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!cola.empty() || en_curso > 0) {
+        cond_vacia.wait(lock);
+    }
+    return errores.empty();
+}
+
+std::vector<std::string> AsyncWriter::getErrores() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return errores;
+}
+
+double AsyncWriter::getTiempoEscritura() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tiempo_escritura_ms;
+}
+
+void AsyncWriter::bucleEscritor() {
+    while (true) {
+        Tarea tarea;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!terminar && cola.empty()) {
+                cond_tarea.wait(lock);
+            }
+            if (cola.empty()) {
+                return;   // terminar y sin trabajo pendiente
+            }
+            tarea = cola.front();
+            cola.pop_front();
+            en_curso++;
+        }
+
+        Timer timer;
+        timer.start();
+        bool correcto = tarea.imagen != nullptr && tarea.imagen->guardarImagen(tarea.ruta.c_str());
+        timer.stop();
+
+        if (!correcto) {
+            std::cerr << "Error guardando: " << tarea.ruta << std::endl;
+        }
+
+        // Devolver el buffer a su dueño (o liberarlo si el servicio es el dueño)
+        if (tarea.devolver) {
+            tarea.devolver(tarea.imagen, correcto);
+        } else {
+            delete tarea.imagen;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tiempo_escritura_ms += timer.getElapsedMilliseconds();
+            if (!correcto) {
+                errores.push_back(tarea.ruta);
+            }
+            en_curso--;
+            if (cola.empty() && en_curso == 0) {
+                cond_vacia.notify_all();
+            }
+        }
+    }
+}
\ No newline at end of file
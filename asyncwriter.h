@@ -0,0 +1,62 @@
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "imagen.h"
+
+// Servicio de escritura en segundo plano (write-behind): los drivers encolan las imágenes
+// terminadas y siguen trabajando mientras hilos de fondo ejecutan guardarImagen.
+class AsyncWriter {
+public:
+    // Se llama desde el hilo escritor al terminar la escritura: devuelve la imagen a su dueño
+    typedef std::function<void(Imagen* imagen, bool correcto)> Devolucion;
+
+    explicit AsyncWriter(int num_hilos = 1);
+
+    // Espera a las escrituras pendientes antes de terminar los hilos
+    ~AsyncWriter();
+
+    // Encolar una imagen para guardarla en "ruta". Sin función de devolución,
+    // el servicio se queda con la imagen y la libera tras escribirla.
+    void encolar(Imagen* imagen, const std::string& ruta, const Devolucion& devolver = Devolucion());
+
+    // Esperar a que se completen todas las escrituras encoladas; false si alguna falló
+    bool esperar();
+
+    // Rutas que no se pudieron escribir (acumuladas desde la creación)
+    std::vector<std::string> getErrores() const;
+
+    // Tiempo total de escritura en los hilos de fondo, en milisegundos
+    double getTiempoEscritura() const;
+
+private:
+    struct Tarea {
+        Imagen* imagen;
+        std::string ruta;
+        Devolucion devolver;
+    };
+
+    void bucleEscritor();
+
+    std::vector<std::thread> hilos;
+    std::deque<Tarea> cola;
+    mutable std::mutex mutex;
+    std::condition_variable cond_tarea;
+    std::condition_variable cond_vacia;
+    int en_curso;
+    bool terminar;
+    std::vector<std::string> errores;
+    double tiempo_escritura_ms;
+
+    // No copiable
+    AsyncWriter(const AsyncWriter&);
+    AsyncWriter& operator=(const AsyncWriter&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "batch.h"
+#include "boundedqueue.h"
+#include "threadpool.h"
+#include "timer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Imagen en tránsito por el pipeline
+struct BatchItem {
+    std::string entrada;
+    std::string salida;
+    bool es_ppm;
+    Imagen* imagen;       // Imagen cargada (PGMImage o PPMImage)
+    Imagen* resultado;    // Imagen filtrada
+};
+
+static bool tieneExtensionImagen(const std::string& nombre) {
+    size_t punto = nombre.find_last_of('.');
+    if (punto == std::string::npos) {
+        return false;
+    }
+    std::string ext = nombre.substr(punto);
+    return ext == ".pgm" || ext == ".ppm" || ext == ".PGM" || ext == ".PPM";
+}
+
+bool BatchPipeline::listarEntradas(const char* ruta, std::vector<std::string>& entradas) {
+    struct stat info;
+    if (stat(ruta, &info) != 0) {
+        std::cerr << "Error: No existe " << ruta << std::endl;
+        return false;
+    }
+
+    if (S_ISDIR(info.st_mode)) {
+        DIR* dir = opendir(ruta);
+        if (dir == nullptr) {
+            std::cerr << "Error: No se pudo abrir el directorio " << ruta << std::endl;
+            return false;
+        }
+        struct dirent* entrada;
+        while ((entrada = readdir(dir)) != nullptr) {
+            std::string nombre(entrada->d_name);
+            if (tieneExtensionImagen(nombre)) {
+                entradas.push_back(std::string(ruta) + "/" + nombre);
+            }
+        }
+        closedir(dir);
+        std::sort(entradas.begin(), entradas.end());
+        return true;
+    }
+
+    // Manifiesto: una ruta por línea
+    std::ifstream manifiesto(ruta);
+    if (!manifiesto) {
+        std::cerr << "Error: No se pudo abrir el manifiesto " << ruta << std::endl;
+        return false;
+    }
+    std::string linea;
+    while (std::getline(manifiesto, linea)) {
+        while (!linea.empty() && (linea[linea.size() - 1] == '\r' || linea[linea.size() - 1] == ' ')) {
+            linea.erase(linea.size() - 1);
+        }
+        if (linea.empty() || linea[0] == '#') {
+            continue;
+        }
+        entradas.push_back(linea);
+    }
+    return true;
+}
+
+std::string BatchPipeline::construirSalida(const std::string& entrada, const char* dir_salida,
+                                           FilterType filtro) {
+    size_t barra = entrada.find_last_of('/');
+    std::string nombre = (barra == std::string::npos) ? entrada : entrada.substr(barra + 1);
+    std::string sufijo = std::string("_") + Filter::filterTypeToString(filtro);
+
+    size_t punto = nombre.find_last_of('.');
+    if (punto != std::string::npos) {
+        nombre = nombre.substr(0, punto) + sufijo + nombre.substr(punto);
+    } else {
+        nombre += sufijo;
+    }
+    return std::string(dir_salida) + "/" + nombre;
+}
+
+// Leer el número mágico para decidir el tipo de imagen
+static bool detectarPPM(const char* archivo, bool& es_ppm) {
+    FILE* file = fopen(archivo, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char magic[3];
+    bool correcto = fscanf(file, "%2s", magic) == 1;
+    fclose(file);
+    if (!correcto) {
+        return false;
+    }
+    es_ppm = strcmp(magic, "P3") == 0;
+    return es_ppm || strcmp(magic, "P2") == 0;
+}
+
+// Sumar tiempos desde varios hilos (en microsegundos)
+static void acumular(std::atomic<long long>& total, const Timer& timer) {
+    total.fetch_add(static_cast<long long>(timer.getElapsedMicroseconds()), std::memory_order_relaxed);
+}
+
+BatchStats BatchPipeline::ejecutar(const std::vector<std::string>& entradas, const char* dir_salida,
+                                   FilterType filtro, int hilos_carga, int hilos_filtro,
+                                   int hilos_guardado, int capacidad) {
+    hilos_carga = std::max(1, hilos_carga);
+    hilos_filtro = std::max(1, hilos_filtro);
+    hilos_guardado = std::max(1, hilos_guardado);
+
+    BoundedQueue<BatchItem*> cola_cargadas(std::max(1, capacidad));
+    BoundedQueue<BatchItem*> cola_filtradas(std::max(1, capacidad));
+
+    std::atomic<int> siguiente(0);
+    std::atomic<int> correctas(0), errores(0);
+    std::atomic<long long> carga_us(0), filtrado_us(0), guardado_us(0);
+
+    // El pool de los filtros LUT/guiado se crea antes de lanzar varios hilos de filtrado
+    ThreadPool::global();
+
+    Timer timer_total;
+    timer_total.start();
+
+    for (int i = 0; i < hilos_carga; i++) {
+        cola_cargadas.registrarProductor();
+    }
+    for (int i = 0; i < hilos_filtro; i++) {
+        cola_filtradas.registrarProductor();
+    }
+
+    // Etapa 1: carga. Las imágenes se reparten dinámicamente entre los hilos de carga.
+    auto etapaCarga = [&]() {
+        while (true) {
+            int k = siguiente.fetch_add(1);
+            if (k >= static_cast<int>(entradas.size())) {
+                break;
+            }
+
+            BatchItem* item = new BatchItem();
+            item->entrada = entradas[k];
+            item->salida = construirSalida(entradas[k], dir_salida, filtro);
+            item->imagen = nullptr;
+            item->resultado = nullptr;
+
+            Timer timer;
+            timer.start();
+            bool correcto = detectarPPM(item->entrada.c_str(), item->es_ppm);
+            if (correcto) {
+                item->imagen = item->es_ppm ? static_cast<Imagen*>(new PPMImage())
+                                            : static_cast<Imagen*>(new PGMImage());
+                correcto = item->imagen->cargarImagen(item->entrada.c_str());
+            }
+            timer.stop();
+            acumular(carga_us, timer);
+
+            if (!correcto) {
+                std::cerr << "Error: No se pudo cargar " << item->entrada << std::endl;
+                errores.fetch_add(1);
+                delete item->imagen;
+                delete item;
+                continue;
+            }
+            cola_cargadas.push(item);
+        }
+        cola_cargadas.productorTerminado();
+    };
+
+    // Etapa 2: filtrado
+    auto etapaFiltro = [&]() {
+        BatchItem* item;
+        while (cola_cargadas.pop(item)) {
+            Timer timer;
+            timer.start();
+            if (item->es_ppm) {
+                item->resultado = Filter::aplicarFiltro(static_cast<PPMImage*>(item->imagen), filtro);
+            } else {
+                item->resultado = Filter::aplicarFiltro(static_cast<PGMImage*>(item->imagen), filtro);
+            }
+            timer.stop();
+            acumular(filtrado_us, timer);
+
+            // La entrada ya no se necesita: liberar cuanto antes acota la memoria en vuelo
+            delete item->imagen;
+            item->imagen = nullptr;
+
+            if (item->resultado == nullptr) {
+                std::cerr << "Error: No se pudo filtrar " << item->entrada << std::endl;
+                errores.fetch_add(1);
+                delete item;
+                continue;
+            }
+            cola_filtradas.push(item);
+        }
+        cola_filtradas.productorTerminado();
+    };
+
+    // Etapa 3: guardado
+    auto etapaGuardado = [&]() {
+        BatchItem* item;
+        while (cola_filtradas.pop(item)) {
+            Timer timer;
+            timer.start();
+            bool correcto = item->resultado->guardarImagen(item->salida.c_str());
+            timer.stop();
+            acumular(guardado_us, timer);
+
+            if (correcto) {
+                correctas.fetch_add(1);
+            } else {
+                std::cerr << "Error guardando: " << item->salida << std::endl;
+                errores.fetch_add(1);
+            }
+            delete item->resultado;
+            delete item;
+        }
+    };
+
+    std::vector<std::thread> hilos;
+    for (int i = 0; i < hilos_carga; i++) {
+        hilos.push_back(std::thread(etapaCarga));
+    }
+    for (int i = 0; i < hilos_filtro; i++) {
+        hilos.push_back(std::thread(etapaFiltro));
+    }
+    for (int i = 0; i < hilos_guardado; i++) {
+        hilos.push_back(std::thread(etapaGuardado));
+    }
+    for (size_t i = 0; i < hilos.size(); i++) {
+        hilos[i].join();
+    }
+
+    timer_total.stop();
+
+    BatchStats stats;
+    stats.imagenes = correctas.load();
+    stats.errores = errores.load();
+    stats.carga_ms = carga_us.load() / 1000.0;
+    stats.filtrado_ms = filtrado_us.load() / 1000.0;
+    stats.guardado_ms = guardado_us.load() / 1000.0;
+    stats.total_ms = timer_total.getElapsedMilliseconds();
+    return stats;
+}
+
+void BatchPipeline::imprimir(const BatchStats& stats, int hilos_carga, int hilos_filtro, int hilos_guardado) {
+    std::cout << std::endl << "=== Resumen del Lote ===" << std::endl;
+    std::cout << "Imágenes procesadas: " << stats.imagenes;
+    if (stats.errores > 0) {
+        std::cout << " (" << stats.errores << " con error)";
+    }
+    std::cout << std::endl;
+    std::cout << "Hilos por etapa: carga " << hilos_carga << ", filtrado " << hilos_filtro
+              << ", guardado " << hilos_guardado << std::endl;
+    std::cout << "Carga (suma): " << stats.carga_ms << " ms" << std::endl;
+    std::cout << "Filtrado (suma): " << stats.filtrado_ms << " ms" << std::endl;
+    std::cout << "Guardado (suma): " << stats.guardado_ms << " ms" << std::endl;
+    std::cout << "Total: " << stats.total_ms << " ms" << std::endl;
+    if (stats.total_ms > 0) {
+        double secuencial = stats.carga_ms + stats.filtrado_ms + stats.guardado_ms;
+        std::cout << "Solapamiento: " << secuencial / stats.total_ms << "x (suma de etapas / tiempo total)" << std::endl;
+        std::cout << "Rendimiento: " << stats.imagenes * 1000.0 / stats.total_ms << " imágenes/s" << std::endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include "filter.h"
+
+// Resultado de procesar un lote
+struct BatchStats {
+    int imagenes;           // Imágenes procesadas correctamente
+    int errores;            // Imágenes que fallaron en alguna etapa
+    double carga_ms;        // Suma de tiempos de carga
+    double filtrado_ms;     // Suma de tiempos de filtrado
+    double guardado_ms;     // Suma de tiempos de guardado
+    double total_ms;        // Tiempo de pared del lote completo
+};
+
+// Procesamiento por lotes en pipeline: carga -> filtrado -> guardado.
+// Cada etapa tiene sus propios hilos y las etapas se comunican con colas acotadas
+// sin bloqueos, de modo que mientras se filtra la imagen k se carga la k+1 y se guarda la k-1.
+class BatchPipeline {
+public:
+    // Listar las imágenes de un directorio (*.pgm, *.ppm, ordenadas) o de un manifiesto
+    // (una ruta por línea; se ignoran líneas vacías y comentarios con '#')
+    static bool listarEntradas(const char* ruta, std::vector<std::string>& entradas);
+
+    // Ruta de salida: <dir_salida>/<nombre>_<filtro>.<ext>
+    static std::string construirSalida(const std::string& entrada, const char* dir_salida,
+                                       FilterType filtro);
+
+    // Procesar el lote. capacidad es el tamaño de cada cola (imágenes en vuelo entre etapas).
+    static BatchStats ejecutar(const std::vector<std::string>& entradas, const char* dir_salida,
+                               FilterType filtro, int hilos_carga, int hilos_filtro,
+                               int hilos_guardado, int capacidad);
+
+    // Imprimir el resumen de un lote
+    static void imprimir(const BatchStats& stats, int hilos_carga, int hilos_filtro, int hilos_guardado);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Cola acotada multiproductor/multiconsumidor sin bloqueos (anillo con números de secuencia).
+// Cada celda guarda la secuencia esperada: un productor solo escribe si la celda está libre
+// para su posición y un consumidor solo lee si ya fue publicada; las posiciones se reservan con CAS.
+template<typename T>
+class BoundedQueue {
+public:
+    // La capacidad se redondea a la siguiente potencia de 2
+    explicit BoundedQueue(size_t capacidad_minima) : productores(0), cerrada(false) {
+        size_t capacidad = 2;
+        while (capacidad < capacidad_minima) {
+            capacidad *= 2;
+        }
+        mascara = capacidad - 1;
+        celdas.reset(new Celda[capacidad]);
+        for (size_t i = 0; i < capacidad; i++) {
+            celdas[i].secuencia.store(i, std::memory_order_relaxed);
+        }
+        pos_escritura.store(0, std::memory_order_relaxed);
+        pos_lectura.store(0, std::memory_order_relaxed);
+    }
+
+    size_t getCapacidad() const { return mascara + 1; }
+
+    // Intentar encolar sin esperar; false si la cola está llena
+    bool intentarPush(const T& dato) {
+        size_t pos = pos_escritura.load(std::memory_order_relaxed);
+        while (true) {
+            Celda& celda = celdas[pos & mascara];
+            size_t sec = celda.secuencia.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(sec) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (pos_escritura.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    celda.dato = dato;
+                    celda.secuencia.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = pos_escritura.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Intentar desencolar sin esperar; false si la cola está vacía
+    bool intentarPop(T& dato) {
+        size_t pos = pos_lectura.load(std::memory_order_relaxed);
+        while (true) {
+            Celda& celda = celdas[pos & mascara];
+            size_t sec = celda.secuencia.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(sec) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (pos_lectura.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    dato = celda.dato;
+                    celda.secuencia.store(pos + mascara + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = pos_lectura.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Encolar esperando mientras la cola esté llena
+    void push(const T& dato) {
+        Espera espera;
+        while (!intentarPush(dato)) {
+            espera.esperar();
+        }
+    }
+
+    // Desencolar esperando mientras la cola esté vacía; false cuando está vacía y cerrada
+    bool pop(T& dato) {
+        Espera espera;
+        while (!intentarPop(dato)) {
+            if (cerrada.load(std::memory_order_acquire)) {
+                // Un último intento: pudo publicarse algo justo antes del cierre
+                return intentarPop(dato);
+            }
+            espera.esperar();
+        }
+        return true;
+    }
+
+    // Registro de productores: la cola se cierra cuando el último termina
+    void registrarProductor() {
+        productores.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void productorTerminado() {
+        if (productores.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            cerrada.store(true, std::memory_order_release);
+        }
+    }
+
+private:
+    struct Celda {
+        std::atomic<size_t> secuencia;
+        T dato;
+    };
+
+    // Espera progresiva: primero cede el procesador y luego duerme, para no robar
+    // núcleos a las etapas que sí tienen trabajo
+    struct Espera {
+        int intentos;
+        Espera() : intentos(0) {}
+        void esperar() {
+            if (intentos < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(intentos < 256 ? 50 : 500));
+            }
+            intentos++;
+        }
+    };
+
+    std::unique_ptr<Celda[]> celdas;
+    size_t mascara;
+    alignas(64) std::atomic<size_t> pos_escritura;
+    alignas(64) std::atomic<size_t> pos_lectura;
+    alignas(64) std::atomic<int> productores;
+    std::atomic<bool> cerrada;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "boxfilter.h"
+#include "parallel.h"
+#include <cstring>
+
+void BoxFilter::sumaFila(const float* fila, int width, int radio, float* salida) {
+    // Ventana inicial [0, r]
+    float suma = 0.0f;
+    for (int x = 0; x <= std::min(radio, width - 1); x++) {
+        suma += fila[x];
+    }
+
+    for (int x = 0; x < width; x++) {
+        salida[x] = suma;
+        // Desplazar la ventana: entra x + r + 1, sale x - r
+        if (x + radio + 1 < width) {
+            suma += fila[x + radio + 1];
+        }
+        if (x - radio >= 0) {
+            suma -= fila[x - radio];
+        }
+    }
+}
+
+void BoxFilter::media(const float* src, int width, int height, int radio, float* dst) {
+    Parallel::paraRango(height, [&](int inicio, int fin) {
+        mediaStreaming(width, height, radio, 1, inicio, fin,
+            [&](int y, float* const* filas) {
+                memcpy(filas[0], src + static_cast<size_t>(y) * width, width * sizeof(float));
+            },
+            [&](int y, const float* const* medias) {
+                memcpy(dst + static_cast<size_t>(y) * width, medias[0], width * sizeof(float));
+            });
+    });
+}
\ No newline at end of file
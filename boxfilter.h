@@ -0,0 +1,94 @@
+#ifndef BOXFILTER_H
+#define BOXFILTER_H
+
+#include <algorithm>
+#include <vector>
+
+// Media de caja (2r+1)x(2r+1) separable con sumas corridas: O(1) por píxel sin importar el radio.
+// En los bordes la ventana se trunca y se normaliza por el número real de muestras.
+class BoxFilter {
+public:
+    // Media de caja de un plano completo, en paralelo por bandas de filas
+    static void media(const float* src, int width, int height, int radio, float* dst);
+
+    // Suma horizontal truncada de una fila: salida[x] = sum(fila[x-r .. x+r])
+    static void sumaFila(const float* fila, int width, int radio, float* salida);
+
+    // Media de caja en streaming de 'planos' planos a la vez sobre las filas [y_ini, y_fin).
+    // generar(y, filas) escribe la fila y de cada plano en filas[p] (width valores);
+    // consumir(y, medias) recibe la media de caja de la fila y de cada plano.
+    // Solo se mantienen en memoria 2r+2 filas de sumas horizontales por plano,
+    // así que las etapas encadenadas trabajan sobre datos en caché.
+    template<typename Generar, typename Consumir>
+    static void mediaStreaming(int width, int height, int radio, int planos,
+                               int y_ini, int y_fin, Generar generar, Consumir consumir);
+};
+
+template<typename Generar, typename Consumir>
+void BoxFilter::mediaStreaming(int width, int height, int radio, int planos,
+                               int y_ini, int y_fin, Generar generar, Consumir consumir) {
+    if (y_ini >= y_fin) {
+        return;
+    }
+
+    const int anillo = 2 * radio + 2;
+    std::vector<float> fila_tmp(static_cast<size_t>(planos) * width);
+    std::vector<float> sumas_h(static_cast<size_t>(anillo) * planos * width);
+    std::vector<float> sumas_col(static_cast<size_t>(planos) * width, 0.0f);
+    std::vector<float> medias(static_cast<size_t>(planos) * width);
+    std::vector<float*> filas(planos), salidas(planos);
+    std::vector<float> inv_h(width);
+
+    for (int p = 0; p < planos; p++) {
+        filas[p] = fila_tmp.data() + static_cast<size_t>(p) * width;
+        salidas[p] = medias.data() + static_cast<size_t>(p) * width;
+    }
+    for (int x = 0; x < width; x++) {
+        int n = std::min(x + radio, width - 1) - std::max(x - radio, 0) + 1;
+        inv_h[x] = 1.0f / n;
+    }
+
+    // Calcular las sumas horizontales de la fila y en su posición del anillo y sumarlas a las columnas
+    auto agregarFila = [&](int y, float signo) {
+        float* destino = sumas_h.data() + static_cast<size_t>(y % anillo) * planos * width;
+        if (signo > 0) {
+            generar(y, filas.data());
+            for (int p = 0; p < planos; p++) {
+                sumaFila(filas[p], width, radio, destino + static_cast<size_t>(p) * width);
+            }
+        }
+        for (size_t i = 0; i < static_cast<size_t>(planos) * width; i++) {
+            sumas_col[i] += signo * destino[i];
+        }
+    };
+
+    // Ventana inicial de la primera fila de la banda
+    for (int y = std::max(y_ini - radio, 0); y <= std::min(y_ini + radio, height - 1); y++) {
+        agregarFila(y, 1.0f);
+    }
+
+    for (int y = y_ini; y < y_fin; y++) {
+        if (y > y_ini) {
+            // Desplazar la ventana vertical una fila
+            if (y - radio - 1 >= 0) {
+                agregarFila(y - radio - 1, -1.0f);
+            }
+            if (y + radio < height) {
+                agregarFila(y + radio, 1.0f);
+            }
+        }
+
+        int n_v = std::min(y + radio, height - 1) - std::max(y - radio, 0) + 1;
+        float inv_v = 1.0f / n_v;
+        for (int p = 0; p < planos; p++) {
+            const float* col = sumas_col.data() + static_cast<size_t>(p) * width;
+            float* salida = salidas[p];
+            for (int x = 0; x < width; x++) {
+                salida[x] = col[x] * inv_v * inv_h[x];
+            }
+        }
+        consumir(y, const_cast<const float* const*>(salidas.data()));
+    }
+}
+
+#endif
\ No newline at end of file
@@ -1,7 +1,24 @@
 #include "filter.h"
+#include "guided.h"
+#include "parallel.h"
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FILTER_LUT_AVX2 1
+#endif
+
+// Con -fopenmp la convolución se reparte por filas entre los hilos de OpenMP
+// y el bucle interior se vectoriza con "omp simd"
+#ifdef _OPENMP
+#include <omp.h>
+#define FILTER_SIMD _Pragma("omp simd")
+#else
+#define FILTER_SIMD
+#endif
+
 // Definición de kernels
 const float Filter::blur_kernel[3][3] = {
     {1.0f/9, 1.0f/9, 1.0f/9},
@@ -21,29 +38,56 @@ const float Filter::sharpening_kernel[3][3] = {
     { 0.0f, -1.0f,  0.0f}
 };
 
+// Aplicar un filtro LUT: estadísticas paralelas, LUT por canal y aplicación paralela
+template<typename ImagenT>
+static ImagenT* aplicarFiltroLUT(const ImagenT* imagen, FilterType tipo, int canales,
+                                 double p_bajo, double p_alto) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return nullptr;
+    }
+    
+    ImagenT* resultado = imagen->crearImagenVacia();
+    if (resultado == nullptr) {
+        return nullptr;
+    }
+    
+    ImageStats stats = Statistics::calcular(imagen);
+    std::vector<int> lut = Filter::construirLUT(stats, tipo, p_bajo, p_alto);
+    
+    const int* entrada = imagen->getPixels();
+    int* salida = resultado->getPixels();
+    int max_color = imagen->getMaxColor();
+    Parallel::paraRango(imagen->getPixelCount(), [&](int inicio, int fin) {
+        Filter::aplicarLUT(entrada, salida, inicio, fin, lut.data(), canales, max_color);
+    });
+    
+    return resultado;
+}
+
 PGMImage* Filter::aplicarFiltro(const PGMImage* imagen, FilterType tipo) {
     if (imagen == nullptr || imagen->getPixels() == nullptr) {
         return nullptr;
     }
     
+    if (esFiltroLUT(tipo)) {
+        return aplicarFiltroLUT(imagen, tipo, 1, 1.0, 99.0);
+    }
+    
+    if (tipo == GUIDED) {
+        return GuidedFilter::aplicar(imagen, GuidedFilter::getRadio(), GuidedFilter::getEps());
+    }
+    
     PGMImage* resultado = imagen->crearImagenVacia();
     if (resultado == nullptr) {
         return nullptr;
     }
     
-    const float (*kernel)[3] = getKernel(tipo);
     int width = imagen->getWidth();
     int height = imagen->getHeight();
-    int max_color = imagen->getMaxColor();
-    const int* pixels = imagen->getPixels();
     
     // Aplicar filtro píxel por píxel
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int valor_filtrado = aplicarConvolucion(pixels, width, height, x, y, kernel, max_color);
-            resultado->setPixelValue(x, y, valor_filtrado);
-        }
-    }
+    filtrarImagen(imagen->getPixels(), width, height, 1, imagen->getMaxColor(), tipo,
+                  resultado->getPixels());
     
     return resultado;
 }
@@ -53,28 +97,119 @@ PPMImage* Filter::aplicarFiltro(const PPMImage* imagen, FilterType tipo) {
         return nullptr;
     }
     
+    if (esFiltroLUT(tipo)) {
+        return aplicarFiltroLUT(imagen, tipo, 3, 1.0, 99.0);
+    }
+    
+    if (tipo == GUIDED) {
+        return GuidedFilter::aplicar(imagen, GuidedFilter::getRadio(), GuidedFilter::getEps());
+    }
+    
     PPMImage* resultado = imagen->crearImagenVacia();
     if (resultado == nullptr) {
         return nullptr;
     }
     
-    const float (*kernel)[3] = getKernel(tipo);
     int width = imagen->getWidth();
     int height = imagen->getHeight();
-    int max_color = imagen->getMaxColor();
-    const int* pixels = imagen->getPixels();
     
     // Aplicar filtro píxel por píxel para cada canal (R, G, B)
+    filtrarImagen(imagen->getPixels(), width, height, 3, imagen->getMaxColor(), tipo,
+                  resultado->getPixels());
+    
+    return resultado;
+}
+
+void Filter::filtrarImagen(const int* pixels, int width, int height, int canales, int max_color,
+                           FilterType tipo, int* salida) {
+    const int stride = width * canales;
+#ifdef _OPENMP
+    // Paralelismo de datos por filas; el reparto (static, guided...) lo fija omp_set_schedule.
+    // Si ya estamos dentro de una región paralela (p. ej. un hilo por filtro) se ejecuta en serie.
+    #pragma omp parallel for schedule(runtime) if(!omp_in_parallel())
     for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int r = aplicarConvolucionColor(pixels, width, height, x, y, 0, kernel, max_color);
-            int g = aplicarConvolucionColor(pixels, width, height, x, y, 1, kernel, max_color);
-            int b = aplicarConvolucionColor(pixels, width, height, x, y, 2, kernel, max_color);
-            resultado->setPixelRGB(x, y, r, g, b);
+        filtrarRegion(pixels, width, height, canales, max_color, tipo,
+                      0, y, width, y + 1, salida + y * stride, stride);
+    }
+#else
+    filtrarRegion(pixels, width, height, canales, max_color, tipo,
+                  0, 0, width, height, salida, stride);
+#endif
+}
+
+// Convolución 3x3 de las muestras [0, n) de una fila interior (sin comprobar bordes).
+// "paso" es la distancia entre píxeles vecinos (canales) y "stride" la distancia entre filas.
+// Cada muestra acumula los 9 productos en el mismo orden que aplicarConvolucion,
+// de modo que el resultado es idéntico al del camino con bordes.
+static void convolucionInterior(const int* centro, int stride, int paso, int n,
+                                const float (*kernel)[3], float peso, int max_color, int* destino) {
+    const int* arriba = centro - stride;
+    const int* abajo = centro + stride;
+    const float k00 = kernel[0][0], k01 = kernel[0][1], k02 = kernel[0][2];
+    const float k10 = kernel[1][0], k11 = kernel[1][1], k12 = kernel[1][2];
+    const float k20 = kernel[2][0], k21 = kernel[2][1], k22 = kernel[2][2];
+    const float divisor = (peso > 0) ? peso : 1.0f;
+    
+    FILTER_SIMD
+    for (int i = 0; i < n; i++) {
+        float sum = arriba[i - paso] * k00;
+        sum += arriba[i] * k01;
+        sum += arriba[i + paso] * k02;
+        sum += centro[i - paso] * k10;
+        sum += centro[i] * k11;
+        sum += centro[i + paso] * k12;
+        sum += abajo[i - paso] * k20;
+        sum += abajo[i] * k21;
+        sum += abajo[i + paso] * k22;
+        int result = static_cast<int>(sum / divisor);
+        destino[i] = std::max(0, std::min(max_color, result));
+    }
+}
+
+void Filter::filtrarRegion(const int* pixels, int width, int height, int canales, int max_color,
+                           FilterType tipo, int x_ini, int y_ini, int x_fin, int y_fin,
+                           int* salida, int stride) {
+    const float (*kernel)[3] = getKernel(tipo);
+    const int stride_fuente = width * canales;
+    
+    // Peso de normalización de un píxel interior (todos los vecinos dentro de la imagen)
+    float peso = 0.0f;
+    for (int ky = 0; ky < 3; ky++) {
+        for (int kx = 0; kx < 3; kx++) {
+            peso += (kernel[ky][kx] > 0) ? kernel[ky][kx] : 0;
         }
     }
     
-    return resultado;
+    for (int y = y_ini; y < y_fin; y++) {
+        int* fila = salida + (y - y_ini) * stride;
+        
+        // [xi, xf) es el tramo interior; los píxeles de borde usan el camino con comprobaciones
+        int xi = std::max(x_ini, 1);
+        int xf = std::min(x_fin, width - 1);
+        bool interior = y > 0 && y < height - 1 && xi < xf;
+        if (!interior) {
+            xi = x_fin;
+            xf = x_fin;
+        }
+        
+        for (int x = x_ini; x < x_fin; x++) {
+            if (x == xi) {
+                convolucionInterior(pixels + y * stride_fuente + xi * canales, stride_fuente, canales,
+                                    (xf - xi) * canales, kernel, peso, max_color,
+                                    fila + (xi - x_ini) * canales);
+                x = xf - 1;
+                continue;
+            }
+            if (canales == 1) {
+                fila[x - x_ini] = aplicarConvolucion(pixels, width, height, x, y, kernel, max_color);
+            } else {
+                int* destino = fila + (x - x_ini) * 3;
+                destino[0] = aplicarConvolucionColor(pixels, width, height, x, y, 0, kernel, max_color);
+                destino[1] = aplicarConvolucionColor(pixels, width, height, x, y, 1, kernel, max_color);
+                destino[2] = aplicarConvolucionColor(pixels, width, height, x, y, 2, kernel, max_color);
+            }
+        }
+    }
 }
 
 FilterType Filter::stringToFilterType(const char* filterName) {
@@ -84,6 +219,12 @@ FilterType Filter::stringToFilterType(const char* filterName) {
         return LAPLACE;
     } else if (strcmp(filterName, "sharpening") == 0 || strcmp(filterName, "sharpen") == 0) {
         return SHARPENING;
+    } else if (strcmp(filterName, "equalize") == 0) {
+        return EQUALIZE;
+    } else if (strcmp(filterName, "stretch") == 0) {
+        return STRETCH;
+    } else if (strcmp(filterName, "guided") == 0) {
+        return GUIDED;
     }
     return BLUR; // Por defecto
 }
@@ -93,6 +234,9 @@ const char* Filter::filterTypeToString(FilterType tipo) {
         case BLUR: return "blur";
         case LAPLACE: return "laplace";
         case SHARPENING: return "sharpening";
+        case EQUALIZE: return "equalize";
+        case STRETCH: return "stretch";
+        case GUIDED: return "guided";
         default: return "unknown";
     }
 }
@@ -168,4 +312,117 @@ const float (*Filter::getKernel(FilterType tipo))[3] {
         case SHARPENING: return sharpening_kernel;
         default: return blur_kernel;
     }
+}
+
+bool Filter::esConvolucion(FilterType tipo) {
+    return tipo == BLUR || tipo == LAPLACE || tipo == SHARPENING;
+}
+
+bool Filter::esFiltroLUT(FilterType tipo) {
+    return tipo == EQUALIZE || tipo == STRETCH;
+}
+
+PGMImage* Filter::aplicarEstiramiento(const PGMImage* imagen, double p_bajo, double p_alto) {
+    return aplicarFiltroLUT(imagen, STRETCH, 1, p_bajo, p_alto);
+}
+
+PPMImage* Filter::aplicarEstiramiento(const PPMImage* imagen, double p_bajo, double p_alto) {
+    return aplicarFiltroLUT(imagen, STRETCH, 3, p_bajo, p_alto);
+}
+
+std::vector<int> Filter::construirLUT(const ImageStats& stats, FilterType tipo,
+                                      double p_bajo, double p_alto) {
+    const int bins = stats.max_color + 1;
+    std::vector<int> lut(static_cast<size_t>(stats.canales) * bins);
+    
+    for (int c = 0; c < stats.canales; c++) {
+        int* lut_canal = lut.data() + c * bins;
+        
+        // Identidad por defecto (imagen constante o rango degenerado)
+        for (int v = 0; v < bins; v++) {
+            lut_canal[v] = v;
+        }
+        
+        if (tipo == EQUALIZE) {
+            // Ecualización clásica: CDF normalizada descontando el primer bin ocupado
+            const long long* hist = stats.getHistograma(c);
+            long long acumulado = 0;
+            long long cdf_min = -1;
+            for (int v = 0; v < bins; v++) {
+                acumulado += hist[v];
+                if (cdf_min < 0 && acumulado > 0) {
+                    cdf_min = acumulado;
+                }
+                if (stats.muestras > cdf_min && acumulado > 0) {
+                    double escala = static_cast<double>(acumulado - cdf_min) / (stats.muestras - cdf_min);
+                    lut_canal[v] = static_cast<int>(std::lround(escala * stats.max_color));
+                }
+            }
+        } else if (tipo == STRETCH) {
+            // Estiramiento lineal del rango [percentil bajo, percentil alto] a [0, max_color]
+            int bajo = stats.percentil(c, p_bajo);
+            int alto = stats.percentil(c, p_alto);
+            if (alto > bajo) {
+                for (int v = 0; v < bins; v++) {
+                    double escala = static_cast<double>(v - bajo) / (alto - bajo);
+                    int valor = static_cast<int>(std::lround(escala * stats.max_color));
+                    lut_canal[v] = std::max(0, std::min(stats.max_color, valor));
+                }
+            }
+        }
+    }
+    
+    return lut;
+}
+
+#ifdef FILTER_LUT_AVX2
+// Gather AVX2 de 8 muestras por instrucción. Los canales intercalados (RGB) se resuelven
+// con tres vectores de desplazamiento que rotan, ya que 24 muestras = 3 vectores = 8 píxeles.
+__attribute__((target("avx2")))
+static int aplicarLUTAVX2(const int* entrada, int* salida, int inicio, int fin,
+                          const int* lut, int canales, int max_color) {
+    const int bins = max_color + 1;
+    __m256i desplazamientos[3];
+    for (int v = 0; v < 3; v++) {
+        alignas(32) int offs[8];
+        for (int j = 0; j < 8; j++) {
+            offs[j] = ((inicio + v * 8 + j) % canales) * bins;
+        }
+        desplazamientos[v] = _mm256_load_si256(reinterpret_cast<const __m256i*>(offs));
+    }
+    
+    const __m256i cero = _mm256_setzero_si256();
+    const __m256i maximo = _mm256_set1_epi32(max_color);
+    
+    int i = inicio;
+    int v = 0;
+    for (; i + 8 <= fin; i += 8) {
+        __m256i valores = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(entrada + i));
+        valores = _mm256_min_epi32(_mm256_max_epi32(valores, cero), maximo);
+        __m256i indices = _mm256_add_epi32(valores, desplazamientos[v]);
+        __m256i resultado = _mm256_i32gather_epi32(lut, indices, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i), resultado);
+        v = (v == 2) ? 0 : v + 1;
+    }
+    return i;
+}
+#endif
+
+void Filter::aplicarLUT(const int* entrada, int* salida, int inicio, int fin,
+                        const int* lut, int canales, int max_color) {
+    const int bins = max_color + 1;
+    int i = inicio;
+    
+#ifdef FILTER_LUT_AVX2
+    static const bool tiene_avx2 = __builtin_cpu_supports("avx2");
+    if (tiene_avx2) {
+        i = aplicarLUTAVX2(entrada, salida, inicio, fin, lut, canales, max_color);
+    }
+#endif
+    
+    // Resto (o ruta escalar sin AVX2)
+    for (; i < fin; i++) {
+        int valor = std::max(0, std::min(max_color, entrada[i]));
+        salida[i] = lut[(i % canales) * bins + valor];
+    }
 }
\ No newline at end of file
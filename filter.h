@@ -4,11 +4,15 @@
 #include "imagen.h"
 #include "PGMimage.h"
 #include "PPMimage.h"
+#include "stats.h"
 
 enum FilterType {
     BLUR,
     LAPLACE,
-    SHARPENING
+    SHARPENING,
+    EQUALIZE,   // Ecualización de histograma (LUT)
+    STRETCH,    // Estiramiento de contraste por percentiles (LUT)
+    GUIDED      // Filtro guiado (preserva bordes)
 };
 
 class Filter {
@@ -26,6 +30,36 @@ public:
     // Obtener kernel según el tipo de filtro
     static const float (*getKernel(FilterType tipo))[3];
 
+    // Filtrar la región [x_ini, x_fin) x [y_ini, y_fin) de un buffer intercalado (1 o 3 canales).
+    // El píxel (x, y) se escribe en salida[(y - y_ini) * stride + (x - x_ini) * canales].
+    // Solo para filtros de convolución; los vecinos se leen de la imagen completa.
+    static void filtrarRegion(const int* pixels, int width, int height, int canales, int max_color,
+                              FilterType tipo, int x_ini, int y_ini, int x_fin, int y_fin,
+                              int* salida, int stride);
+
+    // Filtrar la imagen completa con un filtro de convolución. Compilado con -fopenmp,
+    // las filas se reparten entre los hilos de OpenMP según omp_set_schedule.
+    static void filtrarImagen(const int* pixels, int width, int height, int canales, int max_color,
+                              FilterType tipo, int* salida);
+
+    // Filtros de convolución 3x3 (locales, válidos para filtrarRegion)
+    static bool esConvolucion(FilterType tipo);
+
+    // Filtros basados en tabla de consulta (LUT) en lugar de convolución
+    static bool esFiltroLUT(FilterType tipo);
+
+    // Estiramiento de contraste entre los percentiles p_bajo y p_alto (0-100)
+    static PGMImage* aplicarEstiramiento(const PGMImage* imagen, double p_bajo, double p_alto);
+    static PPMImage* aplicarEstiramiento(const PPMImage* imagen, double p_bajo, double p_alto);
+
+    // Construir la LUT (canales * (max_color + 1) entradas) de un filtro LUT
+    static std::vector<int> construirLUT(const ImageStats& stats, FilterType tipo,
+                                         double p_bajo = 1.0, double p_alto = 99.0);
+
+    // Aplicar una LUT por canal a las muestras [inicio, fin) de un buffer intercalado
+    static void aplicarLUT(const int* entrada, int* salida, int inicio, int fin,
+                           const int* lut, int canales, int max_color);
+
 private:
     // Kernels de filtros
     static const float blur_kernel[3][3];
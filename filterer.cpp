@@ -1,21 +1,64 @@
 #include <iostream>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "PGMimage.h"
 #include "PPMimage.h"
+#include "asyncwriter.h"
+#include "batch.h"
 #include "filter.h"
+#include "geometry.h"
+#include "guided.h"
+#include "iterated.h"
+#include "perfcounters.h"
+#include "pyramid.h"
+#include "resize.h"
+#include "stats.h"
+#include "streaming.h"
+#include "threadpool.h"
 #include "timer.h"
 
 void mostrarUso(const char* programa) {
-    std::cout << "Uso: " << programa << " <entrada> <salida> --f <filtro>" << std::endl;
+    std::cout << "Uso: " << programa << " <entrada> <salida> --f <filtro> [--geom <operación>]" << std::endl;
+    std::cout << "     " << programa << " <entrada> <salida> --f <filtro> --iterations <n> [--tblock <pasos>]" << std::endl;
+    std::cout << "     " << programa << " <entrada> <salida> --f <filtro> --stream [--band <filas>] [--threads <n>]" << std::endl;
+    std::cout << "     " << programa << " <entrada> <salida> --geom <operación>" << std::endl;
+    std::cout << "     " << programa << " <entrada> <salida> --pyramid <niveles> [gauss|box]" << std::endl;
+    std::cout << "     " << programa << " <entrada> <salida> --resize <ancho>x<alto> [area|lanczos]" << std::endl;
+    std::cout << "     " << programa << " <entrada> --stats" << std::endl;
+    std::cout << "     " << programa << " <directorio|manifiesto> <dir_salida> --batch <filtro>" << std::endl;
+    std::cout << "            [--load <n>] [--filter <n>] [--save <n>] [--queue <n>]" << std::endl;
     std::cout << "Ejemplo:" << std::endl;
     std::cout << "  " << programa << " fruit.ppm fruit_blur.ppm --f blur" << std::endl;
     std::cout << "  " << programa << " lena.pgm lena_sharp.pgm --f sharpening" << std::endl;
+    std::cout << "  " << programa << " lena.pgm lena_rot.pgm --f blur --geom rotate90" << std::endl;
+    std::cout << "  " << programa << " lena.pgm lena.pgm --pyramid 4 gauss" << std::endl;
+    std::cout << "  " << programa << " lena.ppm lena_thumb.ppm --resize 256x0 lanczos" << std::endl;
     std::cout << std::endl;
     std::cout << "Filtros disponibles:" << std::endl;
     std::cout << "  - blur      : Filtro de suavizado" << std::endl;
     std::cout << "  - laplace   : Filtro de Laplace (detección de bordes)" << std::endl;
     std::cout << "  - sharpening: Filtro de realce" << std::endl;
+    std::cout << "  - equalize  : Ecualización de histograma" << std::endl;
+    std::cout << "  - stretch   : Estiramiento de contraste (percentiles 1-99)" << std::endl;
+    std::cout << "  - guided    : Filtro guiado (--radius <r> --eps <e>, por defecto 4 y 0.01)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Operaciones geométricas (--geom), fusionadas con el filtro si se indica --f:" << std::endl;
+    std::cout << "  transpose, rotate90, rotate180, rotate270, fliph, flipv" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Pirámide (--pyramid): genera salida_nivel1.ext ... salida_nivelN.ext" << std::endl;
+    std::cout << "  - gauss     : Gaussiano 5x5 + decimación (por defecto)" << std::endl;
+    std::cout << "  - box       : Promedio 2x2 + decimación" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Lote (--batch): carga, filtrado y guardado en pipeline con hilos por etapa" << std::endl;
+    std::cout << "  (por defecto 1 de carga, 1 de filtrado, 1 de guardado y colas de 4 imágenes);" << std::endl;
+    std::cout << "  genera <dir_salida>/<nombre>_<filtro>.<ext>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Redimensionado (--resize): un 0 en ancho o alto conserva la proporción" << std::endl;
+    std::cout << "  - area      : Promedio por área (por defecto)" << std::endl;
+    std::cout << "  - lanczos   : Lanczos3" << std::endl;
     std::cout << std::endl;
     std::cout << "Formatos soportados:" << std::endl;
     std::cout << "  - PGM (P2): Imágenes en escala de grises" << std::endl;
@@ -54,7 +97,232 @@ bool esFormatoPGM(const char* filename) {
     return (strcmp(magic, "P2") == 0);
 }
 
+// Aplicar el filtro con las opciones del modo --f: iteraciones con bloqueo temporal
+// y transformación geométrica (fusionada si es una sola pasada)
+template<typename ImagenT>
+ImagenT* filtrarConOpciones(const ImagenT* imagen, FilterType filtro, GeometryOp geometria,
+                            int iteraciones, int pasos_por_bloque) {
+    if (iteraciones <= 1) {
+        return (geometria == GEOM_NONE)
+            ? Filter::aplicarFiltro(imagen, filtro)
+            : Geometry::aplicarFiltroTransformado(imagen, filtro, geometria);
+    }
+    
+    ImagenT* filtrada = IteratedFilter::aplicar(imagen, filtro, iteraciones, pasos_por_bloque);
+    if (filtrada == nullptr || geometria == GEOM_NONE) {
+        return filtrada;
+    }
+    ImagenT* transformada = Geometry::transformar(filtrada, geometria);
+    delete filtrada;
+    return transformada;
+}
+
+std::string construirNombreNivel(const char* salida, int nivel) {
+    std::string nombre(salida);
+    std::string sufijo = "_nivel" + std::to_string(nivel);
+    
+    // Insertar el nivel antes de la extensión
+    size_t punto_pos = nombre.find_last_of('.');
+    if (punto_pos != std::string::npos) {
+        return nombre.substr(0, punto_pos) + sufijo + nombre.substr(punto_pos);
+    }
+    return nombre + sufijo;
+}
+
+template<typename ImagenT>
+int ejecutarPiramide(const char* archivo_entrada, const char* archivo_salida,
+                     int niveles, PyramidType tipo) {
+    Timer timer_total, timer_carga, timer_piramide, timer_guardado;
+    
+    std::cout << "=== Pirámide de imágenes ===" << std::endl;
+    std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
+    std::cout << "Tipo: " << Pyramid::pyramidTypeToString(tipo) << ", niveles: " << niveles << std::endl;
+    std::cout << std::endl;
+    
+    timer_total.start();
+    
+    ImagenT imagen_original;
+    timer_carga.start();
+    if (!imagen_original.cargarImagen(archivo_entrada)) {
+        std::cerr << "Error: No se pudo cargar la imagen" << std::endl;
+        return 1;
+    }
+    timer_carga.stop();
+    std::cout << "Dimensiones: " << imagen_original.getWidth() << "x" << imagen_original.getHeight() << std::endl;
+    timer_carga.printElapsed("Tiempo de carga");
+    
+    timer_piramide.start();
+    std::vector<ImagenT*> piramide = Pyramid::generarPiramide(&imagen_original, niveles, tipo);
+    timer_piramide.stop();
+    
+    if (piramide.empty()) {
+        std::cerr << "Error: No se pudo generar la pirámide" << std::endl;
+        return 1;
+    }
+    timer_piramide.printElapsed("Tiempo de pirámide");
+    
+    // Los niveles se escriben en paralelo en segundo plano; el escritor libera cada nivel
+    timer_guardado.start();
+    AsyncWriter escritor(static_cast<int>(std::min<size_t>(piramide.size(), 4)));
+    for (size_t k = 0; k < piramide.size(); k++) {
+        std::string nombre = construirNombreNivel(archivo_salida, static_cast<int>(k) + 1);
+        std::cout << "Guardando nivel " << k + 1 << " (" << piramide[k]->getWidth() << "x"
+                  << piramide[k]->getHeight() << "): " << nombre << std::endl;
+        escritor.encolar(piramide[k], nombre);
+    }
+    bool todos_guardados = escritor.esperar();
+    timer_guardado.stop();
+    timer_total.stop();
+    
+    std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
+    timer_carga.printElapsed("Carga");
+    timer_piramide.printElapsed("Pirámide");
+    timer_guardado.printElapsed("Guardado");
+    timer_total.printElapsed("Total");
+    
+    return todos_guardados ? 0 : 1;
+}
+
+template<typename ImagenT>
+int ejecutarRedimensionado(const char* archivo_entrada, const char* archivo_salida,
+                           int ancho, int alto, ResizeType tipo) {
+    Timer timer_total, timer_carga, timer_resize, timer_guardado;
+    
+    std::cout << "=== Redimensionado ===" << std::endl;
+    std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
+    std::cout << "Archivo de salida: " << archivo_salida << std::endl;
+    std::cout << "Modo: " << Resize::resizeTypeToString(tipo) << std::endl;
+    std::cout << std::endl;
+    
+    timer_total.start();
+    
+    ImagenT imagen_original;
+    timer_carga.start();
+    if (!imagen_original.cargarImagen(archivo_entrada)) {
+        std::cerr << "Error: No se pudo cargar la imagen" << std::endl;
+        return 1;
+    }
+    timer_carga.stop();
+    timer_carga.printElapsed("Tiempo de carga");
+    
+    timer_resize.start();
+    ImagenT* imagen_salida = Resize::redimensionar(&imagen_original, ancho, alto, tipo);
+    timer_resize.stop();
+    
+    if (imagen_salida == nullptr) {
+        std::cerr << "Error: No se pudo redimensionar la imagen" << std::endl;
+        return 1;
+    }
+    std::cout << "Dimensiones: " << imagen_original.getWidth() << "x" << imagen_original.getHeight()
+              << " -> " << imagen_salida->getWidth() << "x" << imagen_salida->getHeight() << std::endl;
+    timer_resize.printElapsed("Tiempo de redimensionado");
+    
+    timer_guardado.start();
+    bool guardado = imagen_salida->guardarImagen(archivo_salida);
+    timer_guardado.stop();
+    delete imagen_salida;
+    
+    if (!guardado) {
+        std::cerr << "Error: No se pudo guardar la imagen redimensionada" << std::endl;
+        return 1;
+    }
+    timer_total.stop();
+    
+    std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
+    timer_carga.printElapsed("Carga");
+    timer_resize.printElapsed("Redimensionado");
+    timer_guardado.printElapsed("Guardado");
+    timer_total.printElapsed("Total");
+    return 0;
+}
+
+template<typename ImagenT>
+int ejecutarGeometria(const char* archivo_entrada, const char* archivo_salida, GeometryOp op) {
+    Timer timer_total, timer_carga, timer_geom, timer_guardado;
+    
+    std::cout << "=== Transformación geométrica ===" << std::endl;
+    std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
+    std::cout << "Archivo de salida: " << archivo_salida << std::endl;
+    std::cout << "Operación: " << Geometry::geometryOpToString(op) << std::endl;
+    std::cout << std::endl;
+    
+    timer_total.start();
+    
+    ImagenT imagen_original;
+    timer_carga.start();
+    if (!imagen_original.cargarImagen(archivo_entrada)) {
+        std::cerr << "Error: No se pudo cargar la imagen" << std::endl;
+        return 1;
+    }
+    timer_carga.stop();
+    timer_carga.printElapsed("Tiempo de carga");
+    
+    timer_geom.start();
+    ImagenT* imagen_salida = Geometry::transformar(&imagen_original, op);
+    timer_geom.stop();
+    
+    if (imagen_salida == nullptr) {
+        std::cerr << "Error: No se pudo transformar la imagen" << std::endl;
+        return 1;
+    }
+    timer_geom.printElapsed("Tiempo de transformación");
+    
+    timer_guardado.start();
+    bool guardado = imagen_salida->guardarImagen(archivo_salida);
+    timer_guardado.stop();
+    delete imagen_salida;
+    
+    if (!guardado) {
+        std::cerr << "Error: No se pudo guardar la imagen transformada" << std::endl;
+        return 1;
+    }
+    timer_total.stop();
+    
+    std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
+    timer_carga.printElapsed("Carga");
+    timer_geom.printElapsed("Transformación");
+    timer_guardado.printElapsed("Guardado");
+    timer_total.printElapsed("Total");
+    return 0;
+}
+
+template<typename ImagenT>
+int ejecutarEstadisticas(const char* archivo_entrada) {
+    Timer timer_carga, timer_stats;
+    
+    ImagenT imagen;
+    timer_carga.start();
+    if (!imagen.cargarImagen(archivo_entrada)) {
+        std::cerr << "Error: No se pudo cargar la imagen" << std::endl;
+        return 1;
+    }
+    timer_carga.stop();
+    
+    timer_stats.start();
+    ImageStats stats = Statistics::calcular(&imagen);
+    timer_stats.stop();
+    
+    std::cout << "=== Estadísticas de " << archivo_entrada << " ===" << std::endl;
+    std::cout << "Dimensiones: " << imagen.getWidth() << "x" << imagen.getHeight() << std::endl;
+    Statistics::imprimir(stats);
+    std::cout << std::endl;
+    timer_carga.printElapsed("Carga");
+    timer_stats.printElapsed("Estadísticas");
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    // Modo estadísticas: histograma, min/max, media, desviación y percentiles
+    if (argc >= 3 && strcmp(argv[2], "--stats") == 0) {
+        if (esFormatoPPM(argv[1])) {
+            return ejecutarEstadisticas<PPMImage>(argv[1]);
+        } else if (esFormatoPGM(argv[1])) {
+            return ejecutarEstadisticas<PGMImage>(argv[1]);
+        }
+        std::cerr << "Error: Formato de archivo no soportado o archivo corrupto" << std::endl;
+        return 1;
+    }
+    
     if (argc < 5) {
         std::cout << "Error: Argumentos insuficientes" << std::endl;
         mostrarUso(argv[0]);
@@ -66,6 +334,95 @@ int main(int argc, char* argv[]) {
     const char* flag_filtro = argv[3];
     const char* nombre_filtro = argv[4];
     
+    // Modo pirámide: todos los niveles en una sola ejecución
+    if (strcmp(flag_filtro, "--pyramid") == 0) {
+        int niveles = atoi(argv[4]);
+        if (niveles <= 0) {
+            std::cout << "Error: Número de niveles inválido" << std::endl;
+            mostrarUso(argv[0]);
+            return 1;
+        }
+        PyramidType tipo = (argc > 5) ? Pyramid::stringToPyramidType(argv[5]) : PYRAMID_GAUSS;
+        
+        if (esFormatoPPM(archivo_entrada)) {
+            return ejecutarPiramide<PPMImage>(archivo_entrada, archivo_salida, niveles, tipo);
+        } else if (esFormatoPGM(archivo_entrada)) {
+            return ejecutarPiramide<PGMImage>(archivo_entrada, archivo_salida, niveles, tipo);
+        }
+        std::cerr << "Error: Formato de archivo no soportado o archivo corrupto" << std::endl;
+        return 1;
+    }
+    
+    // Modo solo geometría: transponer, rotar o espejar sin filtro
+    if (strcmp(flag_filtro, "--geom") == 0) {
+        GeometryOp op = Geometry::stringToGeometryOp(argv[4]);
+        if (op == GEOM_NONE) {
+            std::cout << "Error: Operación geométrica desconocida" << std::endl;
+            mostrarUso(argv[0]);
+            return 1;
+        }
+        
+        if (esFormatoPPM(archivo_entrada)) {
+            return ejecutarGeometria<PPMImage>(archivo_entrada, archivo_salida, op);
+        } else if (esFormatoPGM(archivo_entrada)) {
+            return ejecutarGeometria<PGMImage>(archivo_entrada, archivo_salida, op);
+        }
+        std::cerr << "Error: Formato de archivo no soportado o archivo corrupto" << std::endl;
+        return 1;
+    }
+    
+    // Modo redimensionado: <ancho>x<alto>
+    if (strcmp(flag_filtro, "--resize") == 0) {
+        int ancho = 0, alto = 0;
+        if (sscanf(argv[4], "%dx%d", &ancho, &alto) != 2 || ancho < 0 || alto < 0 || (ancho == 0 && alto == 0)) {
+            std::cout << "Error: Tamaño inválido, use <ancho>x<alto>" << std::endl;
+            mostrarUso(argv[0]);
+            return 1;
+        }
+        ResizeType tipo = (argc > 5) ? Resize::stringToResizeType(argv[5]) : RESIZE_AREA;
+        
+        if (esFormatoPPM(archivo_entrada)) {
+            return ejecutarRedimensionado<PPMImage>(archivo_entrada, archivo_salida, ancho, alto, tipo);
+        } else if (esFormatoPGM(archivo_entrada)) {
+            return ejecutarRedimensionado<PGMImage>(archivo_entrada, archivo_salida, ancho, alto, tipo);
+        }
+        std::cerr << "Error: Formato de archivo no soportado o archivo corrupto" << std::endl;
+        return 1;
+    }
+    
+    // Modo lote: directorio o manifiesto de imágenes, en pipeline carga -> filtrado -> guardado
+    if (strcmp(flag_filtro, "--batch") == 0) {
+        FilterType filtro = Filter::stringToFilterType(nombre_filtro);
+        int hilos_carga = 1, hilos_filtro = 1, hilos_guardado = 1, capacidad = 4;
+        for (int i = 5; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "--load") == 0) {
+                hilos_carga = atoi(argv[i + 1]);
+            } else if (strcmp(argv[i], "--filter") == 0) {
+                hilos_filtro = atoi(argv[i + 1]);
+            } else if (strcmp(argv[i], "--save") == 0) {
+                hilos_guardado = atoi(argv[i + 1]);
+            } else if (strcmp(argv[i], "--queue") == 0) {
+                capacidad = atoi(argv[i + 1]);
+            }
+        }
+        
+        std::vector<std::string> entradas;
+        if (!BatchPipeline::listarEntradas(archivo_entrada, entradas)) {
+            return 1;
+        }
+        
+        std::cout << "=== Filterer por Lotes ===" << std::endl;
+        std::cout << "Entradas: " << archivo_entrada << " (" << entradas.size() << " imágenes)" << std::endl;
+        std::cout << "Directorio de salida: " << archivo_salida << std::endl;
+        std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+        
+        BatchStats stats = BatchPipeline::ejecutar(entradas, archivo_salida, filtro, hilos_carga,
+                                                   hilos_filtro, hilos_guardado, capacidad);
+        BatchPipeline::imprimir(stats, std::max(1, hilos_carga), std::max(1, hilos_filtro),
+                                std::max(1, hilos_guardado));
+        return stats.errores == 0 ? 0 : 1;
+    }
+    
     // Verificar flag de filtro
     if (strcmp(flag_filtro, "--f") != 0) {
         std::cout << "Error: Flag de filtro incorrecto. Use --f" << std::endl;
@@ -76,12 +433,89 @@ int main(int argc, char* argv[]) {
     // Obtener tipo de filtro
     FilterType filtro = Filter::stringToFilterType(nombre_filtro);
     
+    // Transformación geométrica opcional, fusionada con el filtro
+    GeometryOp geometria = GEOM_NONE;
+    bool streaming = false;
+    int filas_banda = 32, hilos_stream = 0;
+    int iteraciones = 1, pasos_por_bloque = 0;
+    for (int i = 5; i < argc; i++) {
+        if (strcmp(argv[i], "--stream") == 0) {
+            streaming = true;
+        }
+    }
+    for (int i = 5; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0) {
+            iteraciones = std::max(1, atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "--tblock") == 0) {
+            pasos_por_bloque = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--band") == 0) {
+            filas_banda = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            hilos_stream = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--geom") == 0) {
+            geometria = Geometry::stringToGeometryOp(argv[i + 1]);
+        } else if (strcmp(argv[i], "--radius") == 0) {
+            GuidedFilter::configurar(atoi(argv[i + 1]), 0.0f);
+        } else if (strcmp(argv[i], "--eps") == 0) {
+            GuidedFilter::configurar(0, static_cast<float>(atof(argv[i + 1])));
+        }
+    }
+    
+    // Modo streaming: carga, filtrado y guardado solapados por bandas de filas
+    if (streaming && geometria == GEOM_NONE && iteraciones == 1 && Filter::esConvolucion(filtro)) {
+        if (hilos_stream <= 0) {
+            hilos_stream = ThreadPool::detectarNumHilos();
+        }
+        std::cout << "=== Filterer en Streaming por Bandas ===" << std::endl;
+        std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
+        std::cout << "Archivo de salida: " << archivo_salida << std::endl;
+        std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+        std::cout << "Bandas de " << filas_banda << " filas, " << hilos_stream << " hilos de filtrado" << std::endl;
+        
+        StreamStats stats;
+        if (!BandStreamer::filtrar(archivo_entrada, archivo_salida, filtro, filas_banda, hilos_stream, stats)) {
+            return 1;
+        }
+        
+        std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
+        std::cout << "Carga: " << stats.carga_ms << " ms" << std::endl;
+        std::cout << "Filtrado (suma de bandas): " << stats.filtrado_ms << " ms" << std::endl;
+        std::cout << "Guardado: " << stats.guardado_ms << " ms" << std::endl;
+        std::cout << "Primera banda escrita: " << stats.primera_banda_ms << " ms" << std::endl;
+        std::cout << "Total: " << stats.total_ms << " ms ("
+                  << stats.bandas << " bandas; sin solapamiento serían "
+                  << stats.carga_ms + stats.filtrado_ms + stats.guardado_ms << " ms)" << std::endl;
+        return 0;
+    }
+    if (streaming) {
+        std::cout << "Aviso: --stream solo admite filtros de convolución sin --geom ni --iterations; se usa el modo normal" << std::endl;
+    }
+    
     Timer timer_total, timer_carga, timer_filtro, timer_guardado;
     
+    // Contadores hardware: la carga y el guardado corren en este hilo y el filtrado en el pool global
+    PerfCounters perf_carga, perf_guardado;
+    std::vector<PerfCounters> perf_pool(ThreadPool::global().getNumHilos());
+    PerfLectura perf_filtro;
+    long long pixeles = 0;
+    
     std::cout << "=== Filterer Secuencial ===" << std::endl;
     std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
     std::cout << "Archivo de salida: " << archivo_salida << std::endl;
     std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+    if (geometria != GEOM_NONE) {
+        std::cout << "Geometría: " << Geometry::geometryOpToString(geometria)
+                  << (iteraciones > 1 ? "" : " (fusionada)") << std::endl;
+    }
+    if (iteraciones > 1) {
+        std::cout << "Iteraciones: " << iteraciones << " (bloques de "
+                  << (pasos_por_bloque > 0 ? pasos_por_bloque : IteratedFilter::PASOS_POR_DEFECTO)
+                  << " pasos)" << std::endl;
+    }
+    if (!PerfCounters::disponible()) {
+        std::cout << "Contadores hardware no disponibles: " << PerfCounters::motivoNoDisponible()
+                  << "; solo tiempo de pared" << std::endl;
+    }
     std::cout << std::endl;
     
     timer_total.start();
@@ -95,6 +529,7 @@ int main(int argc, char* argv[]) {
         // Cargar imagen
         std::cout << "Cargando imagen..." << std::endl;
         timer_carga.start();
+        perf_carga.start();
         
         if (!imagen_original->cargarImagen(archivo_entrada)) {
             std::cerr << "Error: No se pudo cargar la imagen PPM" << std::endl;
@@ -102,7 +537,9 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        perf_carga.stop();
         timer_carga.stop();
+        pixeles = static_cast<long long>(imagen_original->getWidth()) * imagen_original->getHeight();
         std::cout << "Dimensiones: " << imagen_original->getWidth() << "x" << imagen_original->getHeight() << std::endl;
         std::cout << "Píxeles totales: " << imagen_original->getWidth() * imagen_original->getHeight() << std::endl;
         timer_carga.printElapsed("Tiempo de carga");
@@ -110,9 +547,12 @@ int main(int argc, char* argv[]) {
         // Aplicar filtro
         std::cout << "Aplicando filtro " << Filter::filterTypeToString(filtro) << "..." << std::endl;
         timer_filtro.start();
+        PerfCounters::iniciarEnPool(ThreadPool::global(), perf_pool);
         
-        PPMImage* imagen_filtrada = Filter::aplicarFiltro(imagen_original, filtro);
+        PPMImage* imagen_filtrada = filtrarConOpciones(imagen_original, filtro, geometria,
+                                                   iteraciones, pasos_por_bloque);
         
+        perf_filtro = PerfCounters::detenerEnPool(ThreadPool::global(), perf_pool);
         timer_filtro.stop();
         
         if (imagen_filtrada == nullptr) {
@@ -126,6 +566,7 @@ int main(int argc, char* argv[]) {
         // Guardar imagen
         std::cout << "Guardando imagen filtrada..." << std::endl;
         timer_guardado.start();
+        perf_guardado.start();
         
         if (!imagen_filtrada->guardarImagen(archivo_salida)) {
             std::cerr << "Error: No se pudo guardar la imagen filtrada" << std::endl;
@@ -134,6 +575,7 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        perf_guardado.stop();
         timer_guardado.stop();
         timer_guardado.printElapsed("Tiempo de guardado");
         
@@ -148,6 +590,7 @@ int main(int argc, char* argv[]) {
         // Cargar imagen
         std::cout << "Cargando imagen..." << std::endl;
         timer_carga.start();
+        perf_carga.start();
         
         if (!imagen_original->cargarImagen(archivo_entrada)) {
             std::cerr << "Error: No se pudo cargar la imagen PGM" << std::endl;
@@ -155,7 +598,9 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        perf_carga.stop();
         timer_carga.stop();
+        pixeles = static_cast<long long>(imagen_original->getWidth()) * imagen_original->getHeight();
         std::cout << "Dimensiones: " << imagen_original->getWidth() << "x" << imagen_original->getHeight() << std::endl;
         std::cout << "Píxeles totales: " << imagen_original->getWidth() * imagen_original->getHeight() << std::endl;
         timer_carga.printElapsed("Tiempo de carga");
@@ -163,9 +608,12 @@ int main(int argc, char* argv[]) {
         // Aplicar filtro
         std::cout << "Aplicando filtro " << Filter::filterTypeToString(filtro) << "..." << std::endl;
         timer_filtro.start();
+        PerfCounters::iniciarEnPool(ThreadPool::global(), perf_pool);
         
-        PGMImage* imagen_filtrada = Filter::aplicarFiltro(imagen_original, filtro);
+        PGMImage* imagen_filtrada = filtrarConOpciones(imagen_original, filtro, geometria,
+                                                   iteraciones, pasos_por_bloque);
         
+        perf_filtro = PerfCounters::detenerEnPool(ThreadPool::global(), perf_pool);
         timer_filtro.stop();
         
         if (imagen_filtrada == nullptr) {
@@ -179,6 +627,7 @@ int main(int argc, char* argv[]) {
         // Guardar imagen
         std::cout << "Guardando imagen filtrada..." << std::endl;
         timer_guardado.start();
+        perf_guardado.start();
         
         if (!imagen_filtrada->guardarImagen(archivo_salida)) {
             std::cerr << "Error: No se pudo guardar la imagen filtrada" << std::endl;
@@ -187,6 +636,7 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        perf_guardado.stop();
         timer_guardado.stop();
         timer_guardado.printElapsed("Tiempo de guardado");
         
@@ -203,8 +653,11 @@ int main(int argc, char* argv[]) {
     
     std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
     timer_carga.printElapsed("Carga");
+    PerfCounters::imprimir(perf_carga.getLectura(), pixeles);
     timer_filtro.printElapsed("Filtrado");
+    PerfCounters::imprimir(perf_filtro, pixeles);
     timer_guardado.printElapsed("Guardado");
+    PerfCounters::imprimir(perf_guardado.getLectura(), pixeles);
     timer_total.printElapsed("Total");
     
     std::cout << "Procesamiento completado exitosamente" << std::endl;
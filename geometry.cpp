@@ -0,0 +1,237 @@
+#include "geometry.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Lado de tesela en píxeles: origen y destino de una tesela caben en L1
+static const int BLOQUE = 32;
+
+// Toda operación se expresa como destino(r, c) = fuente(sy, sx) con:
+//   sin transponer: sy = r, sx = c      transpuesta: sy = c, sx = r
+// y después invertir_y: sy -> alto - 1 - sy, invertir_x: sx -> ancho - 1 - sx
+struct Mapeo {
+    bool transpuesta;
+    bool invertir_x;
+    bool invertir_y;
+};
+
+static Mapeo obtenerMapeo(GeometryOp op) {
+    switch (op) {
+        case GEOM_TRANSPOSE:  return {true, false, false};
+        case GEOM_ROTATE_90:  return {true, false, true};
+        case GEOM_ROTATE_270: return {true, true, false};
+        case GEOM_ROTATE_180: return {false, true, true};
+        case GEOM_FLIP_H:     return {false, true, false};
+        case GEOM_FLIP_V:     return {false, false, true};
+        default:              return {false, false, false};
+    }
+}
+
+// Vista de la fuente: fuente(sy, sx) = base[(sy - oy) * stride + (sx - ox) * canales]
+struct VistaFuente {
+    const int* base;
+    int stride;
+    int ox, oy;
+};
+
+#ifdef __SSE2__
+// Transpuesta 4x4 de enteros de 32 bits en registros
+static inline void transponer4x4(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    __m128i t0 = _mm_unpacklo_epi32(a, b);
+    __m128i t1 = _mm_unpacklo_epi32(c, d);
+    __m128i t2 = _mm_unpackhi_epi32(a, b);
+    __m128i t3 = _mm_unpackhi_epi32(c, d);
+    a = _mm_unpacklo_epi64(t0, t1);
+    b = _mm_unpackhi_epi64(t0, t1);
+    c = _mm_unpacklo_epi64(t2, t3);
+    d = _mm_unpackhi_epi64(t2, t3);
+}
+#endif
+
+// Escribir la tesela destino [r0, r1) x [c0, c1) leyendo de la vista fuente
+static void transformarTesela(const VistaFuente& vista, int src_w, int src_h, int canales,
+                              const Mapeo& m, int* dst, int dst_w,
+                              int r0, int r1, int c0, int c1) {
+    int r = r0;
+
+#ifdef __SSE2__
+    if (m.transpuesta && canales == 1) {
+        // Micro-kernel 4x4: cuatro filas fuente (una por columna destino) se cargan,
+        // se transponen en registros y se guardan como cuatro filas destino
+        for (; r + 4 <= r1; r += 4) {
+            int sx_min = m.invertir_x ? (src_w - 1 - (r + 3)) : r;
+            int c = c0;
+            for (; c + 4 <= c1; c += 4) {
+                __m128i v[4];
+                for (int j = 0; j < 4; j++) {
+                    int sy = m.invertir_y ? (src_h - 1 - (c + j)) : (c + j);
+                    const int* p = vista.base + (sy - vista.oy) * vista.stride + (sx_min - vista.ox);
+                    v[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                }
+                transponer4x4(v[0], v[1], v[2], v[3]);
+                for (int k = 0; k < 4; k++) {
+                    int fila = m.invertir_x ? (r + 3 - k) : (r + k);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + fila * dst_w + c), v[k]);
+                }
+            }
+            // Columnas restantes de estas cuatro filas
+            for (int rr = r; rr < r + 4; rr++) {
+                int sx = m.invertir_x ? (src_w - 1 - rr) : rr;
+                for (int cc = c; cc < c1; cc++) {
+                    int sy = m.invertir_y ? (src_h - 1 - cc) : cc;
+                    dst[rr * dst_w + cc] = vista.base[(sy - vista.oy) * vista.stride + (sx - vista.ox)];
+                }
+            }
+        }
+    }
+#endif
+
+    // Ruta general (filas restantes, PPM y operaciones sin transponer)
+    for (; r < r1; r++) {
+        int* fila = dst + (r * dst_w) * canales;
+        for (int c = c0; c < c1; c++) {
+            int sy = m.transpuesta ? c : r;
+            int sx = m.transpuesta ? r : c;
+            if (m.invertir_y) sy = src_h - 1 - sy;
+            if (m.invertir_x) sx = src_w - 1 - sx;
+            const int* p = vista.base + (sy - vista.oy) * vista.stride + (sx - vista.ox) * canales;
+            for (int k = 0; k < canales; k++) {
+                fila[c * canales + k] = p[k];
+            }
+        }
+    }
+}
+
+// Rectángulo fuente [sx0, sx1) x [sy0, sy1) que alimenta una tesela destino
+static void rectanguloFuente(const Mapeo& m, int src_w, int src_h, int r0, int r1, int c0, int c1,
+                             int& sx0, int& sy0, int& sx1, int& sy1) {
+    int y0 = m.transpuesta ? c0 : r0, y1 = m.transpuesta ? c1 : r1;
+    int x0 = m.transpuesta ? r0 : c0, x1 = m.transpuesta ? r1 : c1;
+    sy0 = m.invertir_y ? src_h - y1 : y0;
+    sy1 = m.invertir_y ? src_h - y0 : y1;
+    sx0 = m.invertir_x ? src_w - x1 : x0;
+    sx1 = m.invertir_x ? src_w - x0 : x1;
+}
+
+// Recorrer todas las teselas del destino, en paralelo por bandas de BLOQUE filas.
+// Si filtro != nullptr, cada tesela fuente se filtra primero en un buffer local.
+static void transformarImagen(const int* src, int src_w, int src_h, int canales, int max_color,
+                              const FilterType* filtro, GeometryOp op, int* dst) {
+    const Mapeo m = obtenerMapeo(op);
+    const int dst_w = m.transpuesta ? src_h : src_w;
+    const int dst_h = m.transpuesta ? src_w : src_h;
+    const int bandas = (dst_h + BLOQUE - 1) / BLOQUE;
+
+    Parallel::paraRango(bandas, [&](int banda_ini, int banda_fin) {
+        std::vector<int> tesela(filtro != nullptr ? BLOQUE * BLOQUE * canales : 0);
+
+        for (int banda = banda_ini; banda < banda_fin; banda++) {
+            int r0 = banda * BLOQUE;
+            int r1 = std::min(r0 + BLOQUE, dst_h);
+            for (int c0 = 0; c0 < dst_w; c0 += BLOQUE) {
+                int c1 = std::min(c0 + BLOQUE, dst_w);
+
+                VistaFuente vista = {src, src_w * canales, 0, 0};
+                if (filtro != nullptr) {
+                    int sx0, sy0, sx1, sy1;
+                    rectanguloFuente(m, src_w, src_h, r0, r1, c0, c1, sx0, sy0, sx1, sy1);
+                    int stride = (sx1 - sx0) * canales;
+                    Filter::filtrarRegion(src, src_w, src_h, canales, max_color, *filtro,
+                                          sx0, sy0, sx1, sy1, tesela.data(), stride);
+                    vista.base = tesela.data();
+                    vista.stride = stride;
+                    vista.ox = sx0;
+                    vista.oy = sy0;
+                }
+
+                transformarTesela(vista, src_w, src_h, canales, m, dst, dst_w, r0, r1, c0, c1);
+            }
+        }
+    });
+}
+
+template<typename ImagenT>
+static ImagenT* transformarGenerico(const ImagenT* imagen, const FilterType* filtro,
+                                    GeometryOp op, int canales) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return nullptr;
+    }
+
+    // Los filtros no locales (LUT, guiado) se aplican primero y luego se transforma
+    if (filtro != nullptr && !Filter::esConvolucion(*filtro)) {
+        ImagenT* filtrada = Filter::aplicarFiltro(imagen, *filtro);
+        if (filtrada == nullptr) {
+            return nullptr;
+        }
+        ImagenT* resultado = transformarGenerico(filtrada, nullptr, op, canales);
+        delete filtrada;
+        return resultado;
+    }
+
+    int w = imagen->getWidth();
+    int h = imagen->getHeight();
+    ImagenT* resultado = Geometry::intercambiaDimensiones(op) ? imagen->crearImagenVacia(h, w)
+                                                             : imagen->crearImagenVacia(w, h);
+    if (resultado == nullptr) {
+        return nullptr;
+    }
+
+    transformarImagen(imagen->getPixels(), w, h, canales, imagen->getMaxColor(),
+                      filtro, op, resultado->getPixels());
+    return resultado;
+}
+
+PGMImage* Geometry::transformar(const PGMImage* imagen, GeometryOp op) {
+    return transformarGenerico(imagen, nullptr, op, 1);
+}
+
+PPMImage* Geometry::transformar(const PPMImage* imagen, GeometryOp op) {
+    return transformarGenerico(imagen, nullptr, op, 3);
+}
+
+PGMImage* Geometry::aplicarFiltroTransformado(const PGMImage* imagen, FilterType tipo, GeometryOp op) {
+    return transformarGenerico(imagen, &tipo, op, 1);
+}
+
+PPMImage* Geometry::aplicarFiltroTransformado(const PPMImage* imagen, FilterType tipo, GeometryOp op) {
+    return transformarGenerico(imagen, &tipo, op, 3);
+}
+
+bool Geometry::intercambiaDimensiones(GeometryOp op) {
+    return obtenerMapeo(op).transpuesta;
+}
+
+GeometryOp Geometry::stringToGeometryOp(const char* nombre) {
+    if (strcmp(nombre, "transpose") == 0) {
+        return GEOM_TRANSPOSE;
+    } else if (strcmp(nombre, "rotate90") == 0 || strcmp(nombre, "90") == 0) {
+        return GEOM_ROTATE_90;
+    } else if (strcmp(nombre, "rotate180") == 0 || strcmp(nombre, "180") == 0) {
+        return GEOM_ROTATE_180;
+    } else if (strcmp(nombre, "rotate270") == 0 || strcmp(nombre, "270") == 0) {
+        return GEOM_ROTATE_270;
+    } else if (strcmp(nombre, "fliph") == 0) {
+        return GEOM_FLIP_H;
+    } else if (strcmp(nombre, "flipv") == 0) {
+        return GEOM_FLIP_V;
+    }
+    return GEOM_NONE; // Por defecto
+}
+
+const char* Geometry::geometryOpToString(GeometryOp op) {
+    switch (op) {
+        case GEOM_NONE: return "none";
+        case GEOM_TRANSPOSE: return "transpose";
+        case GEOM_ROTATE_90: return "rotate90";
+        case GEOM_ROTATE_180: return "rotate180";
+        case GEOM_ROTATE_270: return "rotate270";
+        case GEOM_FLIP_H: return "fliph";
+        case GEOM_FLIP_V: return "flipv";
+        default: return "unknown";
+    }
+}
\ No newline at end of file
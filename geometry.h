@@ -0,0 +1,37 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include "PGMimage.h"
+#include "PPMimage.h"
+#include "filter.h"
+
+enum GeometryOp {
+    GEOM_NONE,
+    GEOM_TRANSPOSE,
+    GEOM_ROTATE_90,     // Horario
+    GEOM_ROTATE_180,
+    GEOM_ROTATE_270,    // Antihorario
+    GEOM_FLIP_H,        // Espejo horizontal
+    GEOM_FLIP_V         // Espejo vertical
+};
+
+class Geometry {
+public:
+    // Transformación geométrica por teselas, en paralelo por bandas de filas destino
+    static PGMImage* transformar(const PGMImage* imagen, GeometryOp op);
+    static PPMImage* transformar(const PPMImage* imagen, GeometryOp op);
+
+    // Filtro y transformación fusionados: cada tesela se filtra en un buffer local
+    // y se escribe ya transformada, sin imagen filtrada intermedia
+    static PGMImage* aplicarFiltroTransformado(const PGMImage* imagen, FilterType tipo, GeometryOp op);
+    static PPMImage* aplicarFiltroTransformado(const PPMImage* imagen, FilterType tipo, GeometryOp op);
+
+    // true si la operación intercambia ancho y alto
+    static bool intercambiaDimensiones(GeometryOp op);
+
+    // Conversión de string a GeometryOp
+    static GeometryOp stringToGeometryOp(const char* nombre);
+    static const char* geometryOpToString(GeometryOp op);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "guided.h"
+#include "boxfilter.h"
+#include "parallel.h"
+#include <algorithm>
+#include <vector>
+
+int GuidedFilter::radio_defecto = 4;
+float GuidedFilter::eps_defecto = 0.01f;
+
+void GuidedFilter::configurar(int radio, float eps) {
+    if (radio > 0) {
+        radio_defecto = radio;
+    }
+    if (eps > 0.0f) {
+        eps_defecto = eps;
+    }
+}
+
+int GuidedFilter::getRadio() {
+    return radio_defecto;
+}
+
+float GuidedFilter::getEps() {
+    return eps_defecto;
+}
+
+PGMImage* GuidedFilter::aplicar(const PGMImage* imagen, int radio, float eps) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return nullptr;
+    }
+
+    PGMImage* resultado = imagen->crearImagenVacia();
+    if (resultado == nullptr) {
+        return nullptr;
+    }
+
+    int n = imagen->getWidth() * imagen->getHeight();
+    const int* pixels = imagen->getPixels();
+    float escala = 1.0f / std::max(1, imagen->getMaxColor());
+    std::vector<float> guia(n);
+    for (int i = 0; i < n; i++) {
+        guia[i] = pixels[i] * escala;
+    }
+
+    filtrar(guia.data(), pixels, imagen->getWidth(), imagen->getHeight(), 1,
+            imagen->getMaxColor(), radio, eps, resultado->getPixels());
+    return resultado;
+}
+
+PPMImage* GuidedFilter::aplicar(const PPMImage* imagen, int radio, float eps) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return nullptr;
+    }
+
+    PPMImage* resultado = imagen->crearImagenVacia();
+    if (resultado == nullptr) {
+        return nullptr;
+    }
+
+    // Guía en escala de grises: luminancia BT.601
+    int n = imagen->getWidth() * imagen->getHeight();
+    const int* pixels = imagen->getPixels();
+    float escala = 1.0f / std::max(1, imagen->getMaxColor());
+    std::vector<float> guia(n);
+    for (int i = 0; i < n; i++) {
+        guia[i] = (0.299f * pixels[i * 3] + 0.587f * pixels[i * 3 + 1] + 0.114f * pixels[i * 3 + 2]) * escala;
+    }
+
+    filtrar(guia.data(), pixels, imagen->getWidth(), imagen->getHeight(), 3,
+            imagen->getMaxColor(), radio, eps, resultado->getPixels());
+    return resultado;
+}
+
+void GuidedFilter::filtrar(const float* guia, const int* pixels, int width, int height, int canales,
+                           int max_color, int radio, float eps, int* salida) {
+    const float escala = 1.0f / std::max(1, max_color);
+
+    // Coeficientes a y b por canal: únicos planos intermedios completos
+    std::vector<float> coef_a(static_cast<size_t>(canales) * width * height);
+    std::vector<float> coef_b(static_cast<size_t>(canales) * width * height);
+
+    // Etapa 1 (fusionada): medias de I, I*I, p e I*p en streaming y, fila a fila,
+    // varianza, covarianza y coeficientes a = cov / (var + eps), b = media_p - a * media_I.
+    // Planos del stream: 0 = I, 1 = I*I, 2 + 2c = p_c, 3 + 2c = I*p_c
+    const int planos_1 = 2 + 2 * canales;
+    Parallel::paraRango(height, [&](int inicio, int fin) {
+        BoxFilter::mediaStreaming(width, height, radio, planos_1, inicio, fin,
+            [&](int y, float* const* filas) {
+                const float* g = guia + static_cast<size_t>(y) * width;
+                const int* p = pixels + static_cast<size_t>(y) * width * canales;
+                for (int x = 0; x < width; x++) {
+                    filas[0][x] = g[x];
+                    filas[1][x] = g[x] * g[x];
+                }
+                for (int c = 0; c < canales; c++) {
+                    for (int x = 0; x < width; x++) {
+                        float v = p[x * canales + c] * escala;
+                        filas[2 + 2 * c][x] = v;
+                        filas[3 + 2 * c][x] = g[x] * v;
+                    }
+                }
+            },
+            [&](int y, const float* const* medias) {
+                const float* media_i = medias[0];
+                const float* media_ii = medias[1];
+                for (int c = 0; c < canales; c++) {
+                    const float* media_p = medias[2 + 2 * c];
+                    const float* media_ip = medias[3 + 2 * c];
+                    float* a = coef_a.data() + (static_cast<size_t>(c) * height + y) * width;
+                    float* b = coef_b.data() + (static_cast<size_t>(c) * height + y) * width;
+                    for (int x = 0; x < width; x++) {
+                        float var_i = media_ii[x] - media_i[x] * media_i[x];
+                        float cov_ip = media_ip[x] - media_i[x] * media_p[x];
+                        a[x] = cov_ip / (var_i + eps);
+                        b[x] = media_p[x] - a[x] * media_i[x];
+                    }
+                }
+            });
+    });
+
+    // Etapa 2 (fusionada): medias de a y b en streaming y salida q = media_a * I + media_b
+    const int planos_2 = 2 * canales;
+    Parallel::paraRango(height, [&](int inicio, int fin) {
+        BoxFilter::mediaStreaming(width, height, radio, planos_2, inicio, fin,
+            [&](int y, float* const* filas) {
+                for (int c = 0; c < canales; c++) {
+                    const float* a = coef_a.data() + (static_cast<size_t>(c) * height + y) * width;
+                    const float* b = coef_b.data() + (static_cast<size_t>(c) * height + y) * width;
+                    std::copy(a, a + width, filas[2 * c]);
+                    std::copy(b, b + width, filas[2 * c + 1]);
+                }
+            },
+            [&](int y, const float* const* medias) {
+                const float* g = guia + static_cast<size_t>(y) * width;
+                int* q = salida + static_cast<size_t>(y) * width * canales;
+                for (int c = 0; c < canales; c++) {
+                    const float* media_a = medias[2 * c];
+                    const float* media_b = medias[2 * c + 1];
+                    for (int x = 0; x < width; x++) {
+                        float v = (media_a[x] * g[x] + media_b[x]) * max_color;
+                        v = std::max(0.0f, std::min(static_cast<float>(max_color), v));
+                        q[x * canales + c] = static_cast<int>(v + 0.5f);
+                    }
+                }
+            });
+    });
+}
\ No newline at end of file
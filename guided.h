@@ -0,0 +1,30 @@
+#ifndef GUIDED_H
+#define GUIDED_H
+
+#include "PGMimage.h"
+#include "PPMimage.h"
+
+// Filtro guiado (He et al.) con guía en escala de grises: suavizado que preserva bordes
+// con costo O(1) por píxel, construido sobre la media de caja de BoxFilter
+class GuidedFilter {
+public:
+    // PGM: la guía es la propia imagen. PPM: la guía es la luminancia y se filtra cada canal.
+    // eps se expresa sobre intensidades normalizadas a [0, 1].
+    static PGMImage* aplicar(const PGMImage* imagen, int radio, float eps);
+    static PPMImage* aplicar(const PPMImage* imagen, int radio, float eps);
+
+    // Parámetros usados por Filter::aplicarFiltro con el tipo GUIDED
+    static void configurar(int radio, float eps);
+    static int getRadio();
+    static float getEps();
+
+private:
+    static int radio_defecto;
+    static float eps_defecto;
+
+    // guia: plano en [0, 1]; pixels: buffer intercalado de 'canales' canales
+    static void filtrar(const float* guia, const int* pixels, int width, int height, int canales,
+                        int max_color, int radio, float eps, int* salida);
+};
+
+#endif
\ No newline at end of file
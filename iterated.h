@@ -0,0 +1,27 @@
+#ifndef ITERATED_H
+#define ITERATED_H
+
+#include "filter.h"
+
+// Aplicación repetida de un filtro de convolución 3x3 con bloqueo temporal.
+// La imagen se divide en bandas de filas; cada banda se carga con un halo de T filas
+// por lado y avanza T pasos de tiempo en buffers locales (el halo válido se estrecha
+// una fila por paso: trapecio), de modo que solo hay un viaje a memoria cada T iteraciones.
+// Las bandas de un mismo bloque temporal son independientes y se procesan en paralelo.
+class IteratedFilter {
+public:
+    // Resultado idéntico a aplicar Filter::aplicarFiltro "iteraciones" veces.
+    // pasos_por_bloque <= 0 usa el valor por defecto. Los filtros no convolucionales
+    // se aplican repetidamente sin bloqueo.
+    static PGMImage* aplicar(const PGMImage* imagen, FilterType tipo, int iteraciones, int pasos_por_bloque);
+    static PPMImage* aplicar(const PPMImage* imagen, FilterType tipo, int iteraciones, int pasos_por_bloque);
+
+    // Avanzar "iteraciones" pasos de entrada a salida (buffers intercalados de alto * width * canales)
+    static void iterar(const int* entrada, int* salida, int width, int height, int canales,
+                       int max_color, FilterType tipo, int iteraciones, int pasos_por_bloque);
+
+    static const int PASOS_POR_DEFECTO = 8;
+    static const int FILAS_POR_BANDA = 32;   // Mínimo; crece con pasos_por_bloque
+};
+
+#endif
\ No newline at end of file
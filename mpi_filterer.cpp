@@ -1,10 +1,21 @@
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
 #include <mpi.h>
+#include <sys/stat.h>
 #include "PGMimage.h"
 #include "PPMimage.h"
+#include "batch.h"
 #include "filter.h"
+#include "mpiio.h"
+#include "mpiwire.h"
+#include "parallel.h"
+#include "pnmtext.h"
+#include "threadpool.h"
 #include "timer.h"
 
 class FilterMPI {
@@ -106,12 +117,33 @@ int FilterMPI::aplicarConvolucionColor(const int* pixels, int width, int height,
 }
 
 void mostrarUso(const char* programa) {
-    std::cout << "Uso: mpirun -np <num_procesos> " << programa << " <entrada> <salida> --f <filtro>" << std::endl;
+    std::cout << "Uso: mpirun -np <num_procesos> " << programa << " <entrada> <salida> --f <filtro> [--decomp rows|2d|dynamic|shm] [--stream] [--tile <filas>] [--threads <n>|auto] [--hint <clave>=<valor>]..." << std::endl;
+    std::cout << "     mpirun -np <num_procesos> " << programa << " <directorio|manifiesto> <dir_salida> --farm <filtro>" << std::endl;
     std::cout << "Ejemplo:" << std::endl;
     std::cout << "  mpirun -np 4 " << programa << " fruit.pgm fruit_blur.pgm --f blur" << std::endl;
     std::cout << "  mpirun -np 2 " << programa << " damma.ppm damma_sharp.ppm --f sharpening" << std::endl;
+    std::cout << "  mpirun -np 6 " << programa << " damma.ppm damma_blur.ppm --f blur --decomp 2d" << std::endl;
+    std::cout << "  mpirun -np 5 " << programa << " damma.ppm damma_blur.ppm --f blur --decomp dynamic --tile 32" << std::endl;
+    std::cout << "  mpirun -np 2 --map-by ppr:1:node --bind-to none " << programa << " damma.ppm damma_blur.ppm --f blur --threads auto" << std::endl;
+    std::cout << "  mpirun -np 4 " << programa << " damma.ppm damma_blur.ppm --f blur --stream" << std::endl;
+    std::cout << "  mpirun -np 8 " << programa << " ./images ./salida --farm blur" << std::endl;
+    std::cout << "  mpirun -np 4 " << programa << " damma_bin.ppm damma_blur_bin.ppm --f blur --hint romio_cb_read=enable" << std::endl;
     std::cout << std::endl;
     std::cout << "Este programa distribuye el procesamiento de filtros entre procesos MPI" << std::endl;
+    std::cout << "--decomp elige el reparto de las imágenes de texto: franjas de filas (rows, por defecto)" << std::endl;
+    std::cout << "o bloques sobre una malla cartesiana de procesos (2d). Con dynamic el proceso 0 reparte" << std::endl;
+    std::cout << "teselas de --tile filas bajo demanda a los demás procesos (clústeres heterogéneos). Con shm" << std::endl;
+    std::cout << "los procesos de cada nodo filtran desde ventanas de memoria compartida y solo los líderes" << std::endl;
+    std::cout << "de nodo se comunican entre sí" << std::endl;
+    std::cout << "Con --stream el proceso 0 envía cada franja en cuanto la parsea y escribe los resultados" << std::endl;
+    std::cout << "en orden según llegan, solapando la lectura y el guardado con el filtrado" << std::endl;
+    std::cout << "Con --farm cada proceso filtra imágenes completas de la lista (las más grandes primero)," << std::endl;
+    std::cout << "repartidas bajo demanda, y las lee y guarda él mismo" << std::endl;
+    std::cout << "--threads reparte el filtrado de cada proceso entre varios hilos (un proceso por nodo" << std::endl;
+    std::cout << "o socket); auto usa los núcleos asignados a cada proceso" << std::endl;
+    std::cout << "Las imágenes binarias (P5/P6) se leen y escriben en paralelo con MPI-IO: cada proceso" << std::endl;
+    std::cout << "accede solo a su franja de filas. --hint pasa pistas a MPI_File_open (p. ej." << std::endl;
+    std::cout << "romio_cb_read, romio_cb_write, cb_nodes, cb_buffer_size)" << std::endl;
 }
 
 bool esFormatoPPM(const char* filename) {
@@ -142,41 +174,49 @@ bool esFormatoPGM(const char* filename) {
     return (strcmp(magic, "P2") == 0);
 }
 
-// Función para aplicar filtro a una porción de imagen PGM
-void procesarPortionPGM(int* result_portion, int width, int height, 
-                       int start_row, int end_row, FilterType filtro, 
-                       int max_color, int* full_image, int rank) {
+// Filas [start_row, end_row) que le tocan a un proceso (las sobrantes van a los primeros)
+void filasDeProceso(int proceso, int height, int size, int& start_row, int& end_row) {
+    int rows_per_process = height / size;
+    int extra_rows = height % size;
+    start_row = proceso * rows_per_process + std::min(proceso, extra_rows);
+    end_row = start_row + rows_per_process + (proceso < extra_rows ? 1 : 0);
+}
+
+// Función para aplicar filtro a una región de imagen PGM.
+// La franja es un bloque de filas_franja x ancho_franja píxeles: los propios y los halos que
+// existan (la fila o columna vecina de cada lado). Se filtra el rectángulo
+// [fila_ini, fila_fin) x [col_ini, col_fin) de la franja; fuera de la franja solo queda el
+// borde real de la imagen. result_portion recibe el rectángulo con ancho_result píxeles por fila.
+void procesarPortionPGM(int* result_portion, int ancho_result, int ancho_franja, int filas_franja,
+                       int fila_ini, int fila_fin, int col_ini, int col_fin, FilterType filtro,
+                       int max_color, const int* franja) {
     
     const float (*kernel)[3] = FilterMPI::getKernel(filtro);
     
-    std::cout << "Proceso " << rank << " procesando filas " << start_row << " a " << end_row - 1 << std::endl;
-    
-    for (int row = start_row; row < end_row; row++) {
-        for (int x = 0; x < width; x++) {
-            int valor = FilterMPI::aplicarConvolucion(full_image, width, height, x, row, kernel, max_color);
-            int local_idx = (row - start_row) * width + x;
+    for (int row = fila_ini; row < fila_fin; row++) {
+        for (int x = col_ini; x < col_fin; x++) {
+            int valor = FilterMPI::aplicarConvolucion(franja, ancho_franja, filas_franja, x, row, kernel, max_color);
+            int local_idx = (row - fila_ini) * ancho_result + (x - col_ini);
             result_portion[local_idx] = valor;
         }
     }
 }
 
-// Función para aplicar filtro a una porción de imagen PPM
-void procesarPortionPPM(int* result_portion, int width, int height,
-                       int start_row, int end_row, FilterType filtro, 
-                       int max_color, int* full_image, int rank) {
+// Función para aplicar filtro a una región de imagen PPM (misma convención que la PGM)
+void procesarPortionPPM(int* result_portion, int ancho_result, int ancho_franja, int filas_franja,
+                       int fila_ini, int fila_fin, int col_ini, int col_fin, FilterType filtro,
+                       int max_color, const int* franja) {
     
     const float (*kernel)[3] = FilterMPI::getKernel(filtro);
     
-    std::cout << "Proceso " << rank << " procesando filas " << start_row << " a " << end_row - 1 << std::endl;
-    
-    for (int row = start_row; row < end_row; row++) {
-        for (int x = 0; x < width; x++) {
+    for (int row = fila_ini; row < fila_fin; row++) {
+        for (int x = col_ini; x < col_fin; x++) {
             // Procesar cada canal (R, G, B)
-            int r = FilterMPI::aplicarConvolucionColor(full_image, width, height, x, row, 0, kernel, max_color);
-            int g = FilterMPI::aplicarConvolucionColor(full_image, width, height, x, row, 1, kernel, max_color);
-            int b = FilterMPI::aplicarConvolucionColor(full_image, width, height, x, row, 2, kernel, max_color);
+            int r = FilterMPI::aplicarConvolucionColor(franja, ancho_franja, filas_franja, x, row, 0, kernel, max_color);
+            int g = FilterMPI::aplicarConvolucionColor(franja, ancho_franja, filas_franja, x, row, 1, kernel, max_color);
+            int b = FilterMPI::aplicarConvolucionColor(franja, ancho_franja, filas_franja, x, row, 2, kernel, max_color);
             
-            int local_idx = ((row - start_row) * width + x) * 3;
+            int local_idx = ((row - fila_ini) * ancho_result + (x - col_ini)) * 3;
             result_portion[local_idx] = r;
             result_portion[local_idx + 1] = g;
             result_portion[local_idx + 2] = b;
@@ -184,253 +224,1735 @@ void procesarPortionPPM(int* result_portion, int width, int height,
     }
 }
 
-int main(int argc, char* argv[]) {
-    int rank, size;
-    
-    MPI_Init(&argc, &argv);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
+// Filtrar el rectángulo propio [fila_desde, fila_hasta) x [col_desde, col_hasta) de un bloque.
+// Los índices son relativos al primer píxel propio, que ocupa la posición
+// (halo_arriba, halo_izquierda) del bloque; local_result tiene ancho_propio píxeles por fila.
+void filtrarRegion(int* local_result, int ancho_propio, const int* bloque, int ancho_bloque,
+                   int filas_bloque, int halo_arriba, int halo_izquierda,
+                   int fila_desde, int fila_hasta, int col_desde, int col_hasta,
+                   bool es_ppm, FilterType filtro, int max_color) {
+    if (fila_desde >= fila_hasta || col_desde >= col_hasta) {
+        return;
+    }
+    int canales = es_ppm ? 3 : 1;
     
-    if (argc < 5) {
-        if (rank == 0) {
-            std::cout << "Error: Argumentos insuficientes" << std::endl;
-            mostrarUso(argv[0]);
+    // Las filas se reparten entre los hilos del pool del proceso (modo híbrido, --threads).
+    // Los hilos del pool nunca llaman a MPI, así que basta con MPI_THREAD_FUNNELED.
+    Parallel::paraRango(fila_hasta - fila_desde, [&](int inicio, int fin) {
+        int desde = fila_desde + inicio;
+        int hasta = fila_desde + fin;
+        int* destino = local_result + (desde * ancho_propio + col_desde) * canales;
+        if (es_ppm) {
+            procesarPortionPPM(destino, ancho_propio, ancho_bloque, filas_bloque,
+                              halo_arriba + desde, halo_arriba + hasta,
+                              halo_izquierda + col_desde, halo_izquierda + col_hasta,
+                              filtro, max_color, bloque);
+        } else {
+            procesarPortionPGM(destino, ancho_propio, ancho_bloque, filas_bloque,
+                              halo_arriba + desde, halo_arriba + hasta,
+                              halo_izquierda + col_desde, halo_izquierda + col_hasta,
+                              filtro, max_color, bloque);
         }
-        MPI_Finalize();
+    });
+}
+
+// Filtrar las filas propias [desde, hasta) de una franja de filas completas; los índices son
+// relativos a la primera fila propia, que ocupa la fila halo_arriba de la franja
+void filtrarFilasPropias(int* local_result, const int* franja, int width, int filas_franja,
+                         int halo_arriba, int desde, int hasta, bool es_ppm,
+                         FilterType filtro, int max_color) {
+    filtrarRegion(local_result, width, franja, width, filas_franja, halo_arriba, 0,
+                  desde, hasta, 0, width, es_ppm, filtro, max_color);
+}
+
+// Procesar una imagen binaria P5/P6 con E/S paralela: cada proceso lee de archivo su franja
+// con los halos (sin reparto ni intercambio de mensajes) y escribe sus filas filtradas
+// en la posición que les corresponde del archivo de salida
+int procesarBinarioMPIIO(const char* archivo_entrada, const char* archivo_salida, FilterType filtro,
+                         const std::vector<std::string>& hints, int rank, int size) {
+    Timer timer_total, timer_carga, timer_filtro, timer_guardado;
+    MPI_Info info = MpiImageIO::crearHints(hints);
+    
+    timer_total.start();
+    timer_carga.start();
+    
+    MPI_File archivo;
+    CabeceraPNM cabecera;
+    if (!MpiImageIO::abrirLectura(archivo_entrada, MPI_COMM_WORLD, info, archivo, cabecera)) {
+        if (info != MPI_INFO_NULL) MPI_Info_free(&info);
         return 1;
     }
     
-    const char* archivo_entrada = argv[1];
-    const char* archivo_salida = argv[2];
-    const char* flag_filtro = argv[3];
-    const char* nombre_filtro = argv[4];
+    int width = cabecera.width;
+    int height = cabecera.height;
+    int stride = width * cabecera.canales;
+    int start_row, end_row;
+    filasDeProceso(rank, height, size, start_row, end_row);
+    int local_rows = end_row - start_row;
     
-    if (strcmp(flag_filtro, "--f") != 0) {
+    // Franja con los halos leídos directamente del archivo
+    int lect_ini = (local_rows > 0) ? std::max(0, start_row - 1) : start_row;
+    int lect_fin = (local_rows > 0) ? std::min(height, end_row + 1) : start_row;
+    int filas_franja = lect_fin - lect_ini;
+    int* franja = (int*)malloc(std::max(1, filas_franja * stride) * sizeof(int));
+    
+    bool correcto = MpiImageIO::leerFilas(archivo, MPI_COMM_WORLD, cabecera, lect_ini, lect_fin, franja);
+    MPI_File_close(&archivo);
+    timer_carga.stop();
+    
+    if (!correcto) {
         if (rank == 0) {
-            std::cout << "Error: Flag de filtro incorrecto. Use --f" << std::endl;
-            mostrarUso(argv[0]);
+            std::cerr << "Error: No se pudo leer la imagen con MPI-IO" << std::endl;
         }
-        MPI_Finalize();
+        free(franja);
+        if (info != MPI_INFO_NULL) MPI_Info_free(&info);
         return 1;
     }
     
-    FilterType filtro = Filter::stringToFilterType(nombre_filtro);
+    if (rank == 0) {
+        std::cout << "Formato detectado: " << (cabecera.canales == 3 ? "PPM (P6)" : "PGM (P5)")
+                  << ", E/S paralela con MPI-IO" << std::endl;
+        std::cout << "Dimensiones: " << width << "x" << height << std::endl;
+        std::cout << std::endl << "Iniciando procesamiento distribuido..." << std::endl;
+    }
+    if (local_rows > 0) {
+        std::cout << "Proceso " << rank << " procesando filas " << start_row << " a " << end_row - 1 << std::endl;
+    }
+    
+    int* local_result = (int*)malloc(std::max(1, local_rows * stride) * sizeof(int));
+    int fila_ini = start_row - lect_ini;
     
-    Timer timer_total, timer_carga, timer_comunicacion, timer_filtro, timer_guardado;
+    timer_filtro.start();
+    filtrarFilasPropias(local_result, franja, width, filas_franja, fila_ini, 0, local_rows,
+                        cabecera.canales == 3, filtro, cabecera.max_color);
+    timer_filtro.stop();
+    
+    timer_guardado.start();
+    CabeceraPNM cabecera_salida;
+    correcto = MpiImageIO::abrirEscritura(archivo_salida, MPI_COMM_WORLD, info, cabecera, archivo, cabecera_salida);
+    if (correcto) {
+        correcto = MpiImageIO::escribirFilas(archivo, MPI_COMM_WORLD, cabecera_salida,
+                                             start_row, end_row, local_result);
+        MPI_File_close(&archivo);
+    }
+    timer_guardado.stop();
+    timer_total.stop();
+    
+    // Cada fase termina cuando acaba el proceso más lento
+    double tiempos[4] = {timer_carga.getElapsedMilliseconds(), timer_filtro.getElapsedMilliseconds(),
+                         timer_guardado.getElapsedMilliseconds(), timer_total.getElapsedMilliseconds()};
+    double maximos[4];
+    MPI_Reduce(tiempos, maximos, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     
     if (rank == 0) {
-        std::cout << "=== Filterer con MPI (" << size << " procesos) ===" << std::endl;
-        std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
-        std::cout << "Archivo de salida: " << archivo_salida << std::endl;
-        std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
-        std::cout << std::endl;
+        if (!correcto) {
+            std::cerr << "Error: No se pudo escribir la imagen con MPI-IO" << std::endl;
+        }
+        double megabytes = height * cabecera.bytesFila() / (1024.0 * 1024.0);
+        std::cout << std::endl << "=== Resumen de Tiempos (máximo entre procesos) ===" << std::endl;
+        std::cout << "Lectura MPI-IO: " << maximos[0] << " ms (" << megabytes / (maximos[0] / 1000.0) << " MB/s)" << std::endl;
+        std::cout << "Filtrado distribuido: " << maximos[1] << " ms" << std::endl;
+        std::cout << "Escritura MPI-IO: " << maximos[2] << " ms (" << megabytes / (maximos[2] / 1000.0) << " MB/s)" << std::endl;
+        std::cout << "Total: " << maximos[3] << " ms" << std::endl;
+        if (correcto) {
+            std::cout << "Procesamiento completado exitosamente con " << size << " procesos MPI" << std::endl;
+        }
     }
     
-    timer_total.start();
+    free(franja);
+    free(local_result);
+    if (info != MPI_INFO_NULL) MPI_Info_free(&info);
+    return correcto ? 0 : 1;
+}
+
+// Forma de repartir la imagen en el camino de texto (--decomp)
+enum Descomposicion {
+    DECOMP_FILAS,   // Franjas de filas completas
+    DECOMP_2D,      // Bloques rectangulares sobre una malla cartesiana de procesos
+    DECOMP_DINAMICA,// Teselas de filas repartidas bajo demanda por el proceso 0
+    DECOMP_SHM      // Franjas por nodo en ventanas de memoria compartida
+};
+
+// Datos que comparten los modos de reparto del camino de texto
+struct ContextoMPI {
+    int rank;
+    int size;
+    int width;
+    int height;
+    int max_color;
+    int canales;
+    FilterType filtro;
+    MPI_Datatype tipo_muestra;
+    void* imagen_red;   // Solo en el proceso 0: imagen empaquetada, recibe también el resultado
+};
+
+// Recoger en el maestro el cómputo y la espera de cada proceso e imprimirlos
+void imprimirTiemposProcesos(const ContextoMPI& ctx, double computo, double espera,
+                             const char* etiqueta_espera = "espera de halos") {
+    double tiempos_locales[2] = {computo, espera};
+    double* tiempos_procesos = nullptr;
+    if (ctx.rank == 0) {
+        tiempos_procesos = (double*)malloc(2 * ctx.size * sizeof(double));
+    }
+    MPI_Gather(tiempos_locales, 2, MPI_DOUBLE, tiempos_procesos, 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    
+    if (ctx.rank == 0) {
+        for (int i = 0; i < ctx.size; i++) {
+            std::cout << "  Proceso " << i << ": cómputo " << tiempos_procesos[2 * i]
+                      << " ms, " << etiqueta_espera << " " << tiempos_procesos[2 * i + 1] << " ms" << std::endl;
+        }
+        free(tiempos_procesos);
+    }
+}
+
+// Reparto por filas: cada proceso recibe solo su franja más una fila de halo por lado y
+// devuelve sus filas filtradas a ctx.imagen_red en el proceso 0
+void filtrarPorFilas(const ContextoMPI& ctx, Timer& timer_filtro) {
+    int rank = ctx.rank;
+    int size = ctx.size;
+    int width = ctx.width;
+    int height = ctx.height;
+    bool es_ppm = ctx.canales == 3;
+    MPI_Datatype tipo_muestra = ctx.tipo_muestra;
+    Timer timer_comunicacion;
+    timer_comunicacion.start();
+    
+    int stride = width * ctx.canales;
+    int start_row, end_row;
+    filasDeProceso(rank, height, size, start_row, end_row);
+    int local_rows = end_row - start_row;
+    
+    int halo_arriba = (local_rows > 0 && start_row > 0) ? 1 : 0;
+    int halo_abajo = (local_rows > 0 && end_row < height) ? 1 : 0;
+    int filas_franja = local_rows + halo_arriba + halo_abajo;
+    int* franja = (int*)malloc(std::max(1, filas_franja * stride) * sizeof(int));
     
-    // Variables para almacenar información de la imagen
-    int width = 0, height = 0, max_color = 0, pixel_count = 0;
-    int* full_image = nullptr;
-    bool es_ppm = false;
+    // Copia de la franja en el formato de red, donde se reciben filas propias y halos
+    void* franja_red = MpiWire::reservar(static_cast<long long>(filas_franja) * stride, tipo_muestra);
+    void* propias_red = MpiWire::desplazar(franja_red, halo_arriba * stride, tipo_muestra);
     
+    // Tamaños y desplazamientos de cada franja (sirven para Scatterv y Gatherv)
+    int* counts = nullptr;
+    int* displs = nullptr;
     if (rank == 0) {
-        // El proceso maestro carga la imagen
-        if (esFormatoPPM(archivo_entrada)) {
-            es_ppm = true;
-            std::cout << "Formato detectado: PPM (P3)" << std::endl;
-            
-            PPMImage imagen_original;
-            timer_carga.start();
-            
-            if (!imagen_original.cargarImagen(archivo_entrada)) {
-                std::cerr << "Error: No se pudo cargar la imagen PPM" << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
-            }
-            
-            timer_carga.stop();
-            
-            width = imagen_original.getWidth();
-            height = imagen_original.getHeight();
-            max_color = imagen_original.getMaxColor();
-            pixel_count = imagen_original.getPixelCount();
-            
-            std::cout << "Dimensiones: " << width << "x" << height << std::endl;
-            timer_carga.printElapsed("Tiempo de carga");
-            
-            // Copiar píxeles
-            full_image = (int*)malloc(pixel_count * sizeof(int));
-            memcpy(full_image, imagen_original.getPixels(), pixel_count * sizeof(int));
-            
-        } else if (esFormatoPGM(archivo_entrada)) {
-            es_ppm = false;
-            std::cout << "Formato detectado: PGM (P2)" << std::endl;
-            
-            PGMImage imagen_original;
-            timer_carga.start();
-            
-            if (!imagen_original.cargarImagen(archivo_entrada)) {
-                std::cerr << "Error: No se pudo cargar la imagen PGM" << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
-            }
-            
-            timer_carga.stop();
-            
-            width = imagen_original.getWidth();
-            height = imagen_original.getHeight();
-            max_color = imagen_original.getMaxColor();
-            pixel_count = imagen_original.getPixelCount();
-            
-            std::cout << "Dimensiones: " << width << "x" << height << std::endl;
-            timer_carga.printElapsed("Tiempo de carga");
-            
-            // Copiar píxeles
-            full_image = (int*)malloc(pixel_count * sizeof(int));
-            memcpy(full_image, imagen_original.getPixels(), pixel_count * sizeof(int));
-            
-        } else {
-            std::cerr << "Error: Formato no soportado" << std::endl;
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        counts = (int*)malloc(size * sizeof(int));
+        displs = (int*)malloc(size * sizeof(int));
+        for (int i = 0; i < size; i++) {
+            int i_start_row, i_end_row;
+            filasDeProceso(i, height, size, i_start_row, i_end_row);
+            counts[i] = (i_end_row - i_start_row) * stride;
+            displs[i] = i_start_row * stride;
         }
     }
     
-    // Broadcast de información básica
-    timer_comunicacion.start();
-    MPI_Bcast(&width, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&height, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&max_color, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&pixel_count, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&es_ppm, 1, MPI_C_BOOL, 0, MPI_COMM_WORLD);
+    MPI_Scatterv(ctx.imagen_red, counts, displs, tipo_muestra,
+                 propias_red, local_rows * stride, tipo_muestra, 0, MPI_COMM_WORLD);
+    
+    timer_comunicacion.stop();
+    
+    if (rank == 0) {
+        timer_comunicacion.printElapsed("Tiempo de comunicación inicial (scatter)");
+        std::cout << "Franja del proceso 0: " << filas_franja << " filas, "
+                  << filas_franja * (long long)stride * sizeof(int) / 1024 << " KB (imagen completa: "
+                  << (long long)height * stride * sizeof(int) / 1024 << " KB)" << std::endl;
+        std::cout << std::endl << "Iniciando procesamiento distribuido..." << std::endl;
+    }
+    
+    // Aplicar filtro especificado
+    int local_size = local_rows * stride;
+    int* local_result = (int*)malloc(std::max(1, local_size) * sizeof(int));
+    
+    if (local_rows > 0) {
+        std::cout << "Proceso " << rank << " procesando filas " << start_row << " a " << end_row - 1 << std::endl;
+    }
+    
+    timer_filtro.start();
+    
+    // Intercambio de halos no bloqueante con los vecinos (MPI_PROC_NULL en los bordes de la
+    // imagen; los procesos sin filas quedan al final del reparto y no tienen vecinos)
+    int vecino_arriba = halo_arriba ? rank - 1 : MPI_PROC_NULL;
+    int vecino_abajo = halo_abajo ? rank + 1 : MPI_PROC_NULL;
+    void* halo_abajo_red = MpiWire::desplazar(propias_red, local_rows * stride, tipo_muestra);
+    void* ultima_propia_red = MpiWire::desplazar(propias_red, std::max(0, local_rows - 1) * stride, tipo_muestra);
+    
+    MPI_Request peticiones[4];
+    MPI_Irecv(franja_red, stride, tipo_muestra, vecino_arriba, 1, MPI_COMM_WORLD, &peticiones[0]);
+    MPI_Irecv(halo_abajo_red, stride, tipo_muestra, vecino_abajo, 0, MPI_COMM_WORLD, &peticiones[1]);
+    MPI_Isend(propias_red, stride, tipo_muestra, vecino_arriba, 0, MPI_COMM_WORLD, &peticiones[2]);
+    MPI_Isend(ultima_propia_red, stride, tipo_muestra, vecino_abajo, 1, MPI_COMM_WORLD, &peticiones[3]);
+    
+    // Mientras viajan los halos se convierten las filas propias y se filtran las interiores,
+    // que no los necesitan
+    Timer timer_interior, timer_espera, timer_bordes;
+    int interior_ini = halo_arriba;
+    int interior_fin = std::max(interior_ini, local_rows - halo_abajo);
+    
+    timer_interior.start();
+    MpiWire::desempaquetar(propias_red, franja + halo_arriba * stride, local_size, tipo_muestra);
+    filtrarFilasPropias(local_result, franja, width, filas_franja, halo_arriba,
+                        interior_ini, interior_fin, es_ppm, ctx.filtro, ctx.max_color);
+    timer_interior.stop();
+    
+    timer_espera.start();
+    MPI_Waitall(4, peticiones, MPI_STATUSES_IGNORE);
+    timer_espera.stop();
+    
+    // Filas de borde: la primera y la última, que dependen de los halos recibidos
+    timer_bordes.start();
+    if (halo_arriba) {
+        MpiWire::desempaquetar(franja_red, franja, stride, tipo_muestra);
+    }
+    if (halo_abajo) {
+        MpiWire::desempaquetar(halo_abajo_red, franja + (filas_franja - 1) * stride, stride, tipo_muestra);
+    }
+    filtrarFilasPropias(local_result, franja, width, filas_franja, halo_arriba,
+                        0, interior_ini, es_ppm, ctx.filtro, ctx.max_color);
+    filtrarFilasPropias(local_result, franja, width, filas_franja, halo_arriba,
+                        interior_fin, local_rows, es_ppm, ctx.filtro, ctx.max_color);
+    timer_bordes.stop();
+    
+    timer_filtro.stop();
     
-    // Todos los procesos necesitan la imagen completa para el filtro (por los bordes)
-    if (rank != 0) {
-        full_image = (int*)malloc(pixel_count * sizeof(int));
+    if (rank == 0) {
+        timer_filtro.printElapsed("Tiempo de filtrado distribuido");
+        std::cout << "Halos no bloqueantes (cómputo de filas interiores solapado con la comunicación):" << std::endl;
     }
+    imprimirTiemposProcesos(ctx, timer_interior.getElapsedMilliseconds() + timer_bordes.getElapsedMilliseconds(),
+                            timer_espera.getElapsedMilliseconds());
+    
+    // Recopilar resultados en el proceso maestro, en el buffer de red de la imagen
+    // (ya repartida y sin uso)
+    timer_comunicacion.reset();
+    timer_comunicacion.start();
+    
+    void* resultado_red = MpiWire::reservar(local_size, tipo_muestra);
+    MpiWire::empaquetar(local_result, resultado_red, local_size, tipo_muestra);
+    
+    MPI_Gatherv(resultado_red, local_size, tipo_muestra,
+                ctx.imagen_red, counts, displs, tipo_muestra,
+                0, MPI_COMM_WORLD);
     
-    MPI_Bcast(full_image, pixel_count, MPI_INT, 0, MPI_COMM_WORLD);
     timer_comunicacion.stop();
     
     if (rank == 0) {
-        timer_comunicacion.printElapsed("Tiempo de comunicación inicial");
+        timer_comunicacion.printElapsed("Tiempo de comunicación final");
+    }
+    
+    free(counts);
+    free(displs);
+    free(franja_red);
+    free(resultado_red);
+    free(franja);
+    free(local_result);
+}
+
+// Reparto en bloques sobre una malla cartesiana de procesos (MPI_Cart_create): cada proceso
+// recibe un rectángulo de la imagen e intercambia una corona de halos con sus cuatro vecinos.
+// El perímetro de un bloque decrece con sqrt(P) en lugar de ser siempre dos filas completas,
+// así que con muchos procesos se mueven menos halos que con el reparto por filas.
+void filtrarCartesiano(const ContextoMPI& ctx, Timer& timer_filtro) {
+    int width = ctx.width;
+    int height = ctx.height;
+    int canales = ctx.canales;
+    bool es_ppm = canales == 3;
+    MPI_Datatype tipo_muestra = ctx.tipo_muestra;
+    Timer timer_comunicacion;
+    timer_comunicacion.start();
+    
+    // Malla lo más cuadrada posible; la dimensión con más procesos se asigna al lado más
+    // largo de la imagen (MPI_Dims_create devuelve las dimensiones en orden decreciente)
+    int dims[2] = {0, 0};
+    int periodos[2] = {0, 0};
+    MPI_Dims_create(ctx.size, 2, dims);
+    if (width > height) {
+        std::swap(dims[0], dims[1]);
+    }
+    MPI_Comm malla;
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periodos, 1, &malla);
+    
+    // MPI puede renumerar los procesos en la malla: localizar en ella al maestro
+    int raiz;
+    int maestro = 0;
+    MPI_Group grupo_mundo, grupo_malla;
+    MPI_Comm_group(MPI_COMM_WORLD, &grupo_mundo);
+    MPI_Comm_group(malla, &grupo_malla);
+    MPI_Group_translate_ranks(grupo_mundo, 1, &maestro, grupo_malla, &raiz);
+    MPI_Group_free(&grupo_mundo);
+    MPI_Group_free(&grupo_malla);
+    
+    int rank_malla;
+    int coords[2];
+    MPI_Comm_rank(malla, &rank_malla);
+    MPI_Cart_coords(malla, rank_malla, 2, coords);
+    
+    // Filas y columnas propias; si la imagen tiene menos filas o columnas que la malla,
+    // los últimos procesos de esa dimensión se quedan sin bloque
+    int fila_ini, fila_fin, col_ini, col_fin;
+    filasDeProceso(coords[0], height, dims[0], fila_ini, fila_fin);
+    filasDeProceso(coords[1], width, dims[1], col_ini, col_fin);
+    int filas = fila_fin - fila_ini;
+    int cols = col_fin - col_ini;
+    bool vacio = (filas == 0 || cols == 0);
+    
+    int halo_arriba = (!vacio && fila_ini > 0) ? 1 : 0;
+    int halo_abajo = (!vacio && fila_fin < height) ? 1 : 0;
+    int halo_izquierda = (!vacio && col_ini > 0) ? 1 : 0;
+    int halo_derecha = (!vacio && col_fin < width) ? 1 : 0;
+    
+    int vecino_arriba, vecino_abajo, vecino_izquierda, vecino_derecha;
+    MPI_Cart_shift(malla, 0, 1, &vecino_arriba, &vecino_abajo);
+    MPI_Cart_shift(malla, 1, 1, &vecino_izquierda, &vecino_derecha);
+    if (!halo_arriba) vecino_arriba = MPI_PROC_NULL;
+    if (!halo_abajo) vecino_abajo = MPI_PROC_NULL;
+    if (!halo_izquierda) vecino_izquierda = MPI_PROC_NULL;
+    if (!halo_derecha) vecino_derecha = MPI_PROC_NULL;
+    
+    // Bloque local: píxeles propios rodeados por los halos que existan
+    int ancho_bloque = cols + halo_izquierda + halo_derecha;
+    int filas_bloque = filas + halo_arriba + halo_abajo;
+    int stride_bloque = ancho_bloque * canales;
+    long long muestras_bloque = static_cast<long long>(filas_bloque) * stride_bloque;
+    int* bloque = (int*)malloc(std::max(1LL, muestras_bloque) * sizeof(int));
+    void* bloque_red = MpiWire::reservar(muestras_bloque, tipo_muestra);
+    
+    // Posición en muestras de (fila, columna) del bloque local
+    auto posicion = [&](int fila, int columna) -> long long {
+        return static_cast<long long>(fila) * stride_bloque + static_cast<long long>(columna) * canales;
+    };
+    auto enBloqueRed = [&](int fila, int columna) -> void* {
+        return MpiWire::desplazar(bloque_red, posicion(fila, columna), tipo_muestra);
+    };
+    
+    // Tipos derivados sobre el bloque local: el rectángulo propio, una columna de halo
+    // (un píxel por fila propia, con salto de una fila del bloque) y una fila completa,
+    // esquinas incluidas
+    MPI_Datatype tipo_propio, tipo_columna, tipo_fila;
+    MPI_Type_vector(filas, cols * canales, stride_bloque, tipo_muestra, &tipo_propio);
+    MPI_Type_vector(filas, canales, stride_bloque, tipo_muestra, &tipo_columna);
+    MPI_Type_contiguous(stride_bloque, tipo_muestra, &tipo_fila);
+    MPI_Type_commit(&tipo_propio);
+    MPI_Type_commit(&tipo_columna);
+    MPI_Type_commit(&tipo_fila);
+    
+    // El maestro describe cada bloque dentro de la imagen con un vector (filas del bloque,
+    // con salto de una fila de la imagen); sirve para repartir y para recoger el resultado
+    const int ETIQUETA_BLOQUE = 4;
+    std::vector<MPI_Datatype> tipos_bloque;
+    std::vector<void*> origenes_bloque;
+    if (rank_malla == raiz) {
+        for (int i = 0; i < ctx.size; i++) {
+            int c[2];
+            MPI_Cart_coords(malla, i, 2, c);
+            int f0, f1, c0, c1;
+            filasDeProceso(c[0], height, dims[0], f0, f1);
+            filasDeProceso(c[1], width, dims[1], c0, c1);
+            MPI_Datatype tipo;
+            MPI_Type_vector(f1 - f0, (c1 - c0) * canales, width * canales, tipo_muestra, &tipo);
+            MPI_Type_commit(&tipo);
+            tipos_bloque.push_back(tipo);
+            origenes_bloque.push_back(MpiWire::desplazar(ctx.imagen_red,
+                (static_cast<long long>(f0) * width + c0) * canales, tipo_muestra));
+        }
+    }
+    
+    std::vector<MPI_Request> reparto;
+    reparto.reserve(tipos_bloque.size() + 1);
+    reparto.push_back(MPI_REQUEST_NULL);
+    MPI_Irecv(enBloqueRed(halo_arriba, halo_izquierda), 1, tipo_propio, raiz, ETIQUETA_BLOQUE,
+              malla, &reparto[0]);
+    for (size_t i = 0; i < tipos_bloque.size(); i++) {
+        reparto.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(origenes_bloque[i], 1, tipos_bloque[i], static_cast<int>(i), ETIQUETA_BLOQUE,
+                  malla, &reparto.back());
+    }
+    MPI_Waitall(static_cast<int>(reparto.size()), reparto.data(), MPI_STATUSES_IGNORE);
+    
+    timer_comunicacion.stop();
+    
+    // Volumen de halos por proceso frente al que tendría el reparto por filas con los mismos procesos
+    int f0, f1;
+    filasDeProceso(ctx.rank, height, ctx.size, f0, f1);
+    long long halos[2];
+    halos[0] = (static_cast<long long>(halo_arriba + halo_abajo) * ancho_bloque
+                + static_cast<long long>(halo_izquierda + halo_derecha) * filas) * canales;
+    halos[1] = (f1 > f0) ? static_cast<long long>((f0 > 0 ? 1 : 0) + (f1 < height ? 1 : 0)) * width * canales : 0;
+    long long halos_max[2], halos_total[2];
+    MPI_Reduce(halos, halos_max, 2, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(halos, halos_total, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    
+    if (ctx.rank == 0) {
+        timer_comunicacion.printElapsed("Tiempo de comunicación inicial (bloques 2D)");
+        std::cout << "Malla de procesos: " << dims[0] << " x " << dims[1] << " (filas x columnas)" << std::endl;
+        std::cout << "Muestras de halo por proceso (máximo / total): bloques 2D " << halos_max[0]
+                  << " / " << halos_total[0] << "; franjas de filas " << halos_max[1]
+                  << " / " << halos_total[1] << std::endl;
         std::cout << std::endl << "Iniciando procesamiento distribuido..." << std::endl;
     }
     
-    // Dividir trabajo por filas
-    int rows_per_process = height / size;
-    int extra_rows = height % size;
+    int local_size = filas * cols * canales;
+    int* local_result = (int*)malloc(std::max(1, local_size) * sizeof(int));
     
-    int start_row = rank * rows_per_process + std::min(rank, extra_rows);
-    int end_row = start_row + rows_per_process + (rank < extra_rows ? 1 : 0);
-    int local_rows = end_row - start_row;
+    if (!vacio) {
+        std::cout << "Proceso " << ctx.rank << " procesando filas " << fila_ini << " a " << fila_fin - 1
+                  << ", columnas " << col_ini << " a " << col_fin - 1 << std::endl;
+    }
     
-    // Aplicar filtro especificado
-    int local_size = es_ppm ? local_rows * width * 3 : local_rows * width;
-    int* local_result = (int*)malloc(local_size * sizeof(int));
+    // Convertir a int el rectángulo [fila_desde, fila_hasta) x [col_desde, col_hasta) del bloque local
+    auto desempaquetarRect = [&](int fila_desde, int fila_hasta, int col_desde, int col_hasta) {
+        for (int f = fila_desde; f < fila_hasta; f++) {
+            MpiWire::desempaquetar(enBloqueRed(f, col_desde), bloque + posicion(f, col_desde),
+                                   static_cast<long long>(col_hasta - col_desde) * canales, tipo_muestra);
+        }
+    };
+    // Filtrar un rectángulo en coordenadas propias
+    auto filtrar = [&](int fila_desde, int fila_hasta, int col_desde, int col_hasta) {
+        filtrarRegion(local_result, cols, bloque, ancho_bloque, filas_bloque, halo_arriba, halo_izquierda,
+                      fila_desde, fila_hasta, col_desde, col_hasta, es_ppm, ctx.filtro, ctx.max_color);
+    };
     
     timer_filtro.start();
+    // Timer no acumula: cada tramo se mide aparte y se suma
+    Timer tramo;
+    double computo = 0.0, espera = 0.0;
+    const int HACIA_ARRIBA = 0, HACIA_ABAJO = 1, HACIA_IZQUIERDA = 2, HACIA_DERECHA = 3;
+    int ultima_fila = halo_arriba + std::max(0, filas - 1);
+    int ultima_col = halo_izquierda + std::max(0, cols - 1);
     
-    if (es_ppm) {
-        procesarPortionPPM(local_result, width, height, start_row, end_row, 
-                          filtro, max_color, full_image, rank);
-    } else {
-        procesarPortionPGM(local_result, width, height, start_row, end_row,
-                          filtro, max_color, full_image, rank);
+    // Fase 1: columnas de halo (solo filas propias), con tipos vector
+    MPI_Request columnas[4];
+    MPI_Irecv(enBloqueRed(halo_arriba, 0), 1, tipo_columna, vecino_izquierda, HACIA_DERECHA, malla, &columnas[0]);
+    MPI_Irecv(enBloqueRed(halo_arriba, halo_izquierda + cols), 1, tipo_columna, vecino_derecha, HACIA_IZQUIERDA,
+              malla, &columnas[1]);
+    MPI_Isend(enBloqueRed(halo_arriba, halo_izquierda), 1, tipo_columna, vecino_izquierda, HACIA_IZQUIERDA,
+              malla, &columnas[2]);
+    MPI_Isend(enBloqueRed(halo_arriba, ultima_col), 1, tipo_columna, vecino_derecha, HACIA_DERECHA,
+              malla, &columnas[3]);
+    
+    // Mientras tanto: el interior, que no depende de ningún halo
+    int interior_fila_ini = halo_arriba;
+    int interior_fila_fin = std::max(interior_fila_ini, filas - halo_abajo);
+    int interior_col_ini = halo_izquierda;
+    int interior_col_fin = std::max(interior_col_ini, cols - halo_derecha);
+    
+    tramo.start();
+    desempaquetarRect(halo_arriba, halo_arriba + filas, halo_izquierda, halo_izquierda + cols);
+    filtrar(interior_fila_ini, interior_fila_fin, interior_col_ini, interior_col_fin);
+    tramo.stop();
+    computo += tramo.getElapsedMilliseconds();
+    
+    tramo.start();
+    MPI_Waitall(4, columnas, MPI_STATUSES_IGNORE);
+    tramo.stop();
+    espera += tramo.getElapsedMilliseconds();
+    
+    // Fase 2: filas de halo completas; llevan ya las columnas recibidas, así que las
+    // esquinas llegan sin mensajes diagonales
+    MPI_Request filas_halo[4];
+    MPI_Irecv(enBloqueRed(0, 0), 1, tipo_fila, vecino_arriba, HACIA_ABAJO, malla, &filas_halo[0]);
+    MPI_Irecv(enBloqueRed(halo_arriba + filas, 0), 1, tipo_fila, vecino_abajo, HACIA_ARRIBA, malla, &filas_halo[1]);
+    MPI_Isend(enBloqueRed(halo_arriba, 0), 1, tipo_fila, vecino_arriba, HACIA_ARRIBA, malla, &filas_halo[2]);
+    MPI_Isend(enBloqueRed(ultima_fila, 0), 1, tipo_fila, vecino_abajo, HACIA_ABAJO, malla, &filas_halo[3]);
+    
+    // Mientras tanto: las columnas de borde de las filas interiores
+    tramo.start();
+    if (halo_izquierda) {
+        desempaquetarRect(halo_arriba, halo_arriba + filas, 0, 1);
     }
+    if (halo_derecha) {
+        desempaquetarRect(halo_arriba, halo_arriba + filas, ancho_bloque - 1, ancho_bloque);
+    }
+    filtrar(interior_fila_ini, interior_fila_fin, 0, interior_col_ini);
+    filtrar(interior_fila_ini, interior_fila_fin, interior_col_fin, cols);
+    tramo.stop();
+    computo += tramo.getElapsedMilliseconds();
+    
+    tramo.start();
+    MPI_Waitall(4, filas_halo, MPI_STATUSES_IGNORE);
+    tramo.stop();
+    espera += tramo.getElapsedMilliseconds();
+    
+    // Filas de borde completas
+    tramo.start();
+    if (halo_arriba) {
+        desempaquetarRect(0, 1, 0, ancho_bloque);
+    }
+    if (halo_abajo) {
+        desempaquetarRect(filas_bloque - 1, filas_bloque, 0, ancho_bloque);
+    }
+    filtrar(0, interior_fila_ini, 0, cols);
+    filtrar(interior_fila_fin, filas, 0, cols);
+    tramo.stop();
+    computo += tramo.getElapsedMilliseconds();
     
     timer_filtro.stop();
     
-    if (rank == 0) {
+    if (ctx.rank == 0) {
         timer_filtro.printElapsed("Tiempo de filtrado distribuido");
+        std::cout << "Halos no bloqueantes en dos fases (columnas y filas con esquinas):" << std::endl;
     }
+    imprimirTiemposProcesos(ctx, computo, espera);
     
-    // Recopilar resultados en el proceso maestro
+    // Recoger los bloques: cada proceso envía su rectángulo contiguo y el maestro lo coloca
+    // en la imagen con el mismo tipo vector del reparto
     timer_comunicacion.reset();
     timer_comunicacion.start();
     
-    int* final_result = nullptr;
+    void* resultado_red = MpiWire::reservar(local_size, tipo_muestra);
+    MpiWire::empaquetar(local_result, resultado_red, local_size, tipo_muestra);
+    
+    std::vector<MPI_Request> recogida;
+    recogida.reserve(tipos_bloque.size() + 1);
+    recogida.push_back(MPI_REQUEST_NULL);
+    MPI_Isend(resultado_red, local_size, tipo_muestra, raiz, ETIQUETA_BLOQUE, malla, &recogida[0]);
+    for (size_t i = 0; i < tipos_bloque.size(); i++) {
+        recogida.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(origenes_bloque[i], 1, tipos_bloque[i], static_cast<int>(i), ETIQUETA_BLOQUE,
+                  malla, &recogida.back());
+    }
+    MPI_Waitall(static_cast<int>(recogida.size()), recogida.data(), MPI_STATUSES_IGNORE);
+    
+    timer_comunicacion.stop();
+    
+    if (ctx.rank == 0) {
+        timer_comunicacion.printElapsed("Tiempo de comunicación final");
+    }
+    
+    for (size_t i = 0; i < tipos_bloque.size(); i++) {
+        MPI_Type_free(&tipos_bloque[i]);
+    }
+    MPI_Type_free(&tipo_propio);
+    MPI_Type_free(&tipo_columna);
+    MPI_Type_free(&tipo_fila);
+    MPI_Comm_free(&malla);
+    free(bloque_red);
+    free(resultado_red);
+    free(bloque);
+    free(local_result);
+}
+
+// Reparto dinámico maestro-trabajador: el proceso 0 no filtra, solo coordina. Divide la
+// imagen en teselas de filas_tesela filas completas, entrega dos a cada trabajador y, cada
+// vez que recibe un resultado (con la posición de su tesela), le envía la siguiente. Los
+// nodos rápidos piden más trabajo, así que el más lento ya no marca el ritmo del conjunto.
+void filtrarDinamico(const ContextoMPI& ctx, int filas_tesela, Timer& timer_filtro) {
+    int rank = ctx.rank;
+    int width = ctx.width;
+    int height = ctx.height;
+    bool es_ppm = ctx.canales == 3;
+    int stride = width * ctx.canales;
+    MPI_Datatype tipo_muestra = ctx.tipo_muestra;
+    int trabajadores = ctx.size - 1;
+    if (filas_tesela <= 0) {
+        // Unas ocho teselas por trabajador: margen para compensar nodos lentos sin
+        // multiplicar los mensajes
+        filas_tesela = std::max(1, (height + 8 * trabajadores - 1) / (8 * trabajadores));
+    }
+    int num_teselas = (height + filas_tesela - 1) / filas_tesela;
+    
+    const int ETIQUETA_TESELA = 10;
+    const int ETIQUETA_TESELA_DATOS = 11;
+    const int ETIQUETA_RESULTADO = 12;
+    const int ETIQUETA_RESULTADO_DATOS = 13;
+    const int ETIQUETA_FIN = 14;
+    const int TESELAS_EN_VUELO = 2;   // Mientras filtra una, la siguiente ya está en camino
+    
     if (rank == 0) {
-        final_result = (int*)malloc(pixel_count * sizeof(int));
+        std::cout << "Reparto dinámico: " << num_teselas << " teselas de " << filas_tesela
+                  << " filas para " << trabajadores << " trabajadores (el proceso 0 coordina)" << std::endl;
+        std::cout << std::endl << "Iniciando procesamiento distribuido..." << std::endl;
     }
     
-    // Calcular desplazamientos y tamaños para Gatherv
-    int* recvcounts = nullptr;
-    int* displs = nullptr;
+    // [teselas, filas, cómputo en ms, tiempo activo en ms] de cada proceso
+    double estadisticas[4] = {0.0, 0.0, 0.0, 0.0};
+    timer_filtro.start();
     
     if (rank == 0) {
-        recvcounts = (int*)malloc(size * sizeof(int));
-        displs = (int*)malloc(size * sizeof(int));
+        // Los resultados van a un buffer aparte: la imagen de entrada sigue enviándose
+        // (con sus halos) mientras llegan teselas ya filtradas
+        long long muestras = static_cast<long long>(height) * stride;
+        void* resultado_red = MpiWire::reservar(muestras, tipo_muestra);
+        std::vector<int> cabeceras(2 * num_teselas);
+        std::vector<int> pendientes(ctx.size, 0);
+        std::vector<MPI_Request> envios;
+        int siguiente = 0;
         
-        for (int i = 0; i < size; i++) {
-            int i_start_row = i * rows_per_process + std::min(i, extra_rows);
-            int i_end_row = i_start_row + rows_per_process + (i < extra_rows ? 1 : 0);
-            int i_local_rows = i_end_row - i_start_row;
+        // Enviar la siguiente tesela (filas propias más halos) al trabajador; false si no quedan
+        auto enviarTesela = [&](int trabajador) -> bool {
+            if (siguiente >= num_teselas) {
+                return false;
+            }
+            int* cabecera = &cabeceras[2 * siguiente];
+            cabecera[0] = siguiente * filas_tesela;
+            cabecera[1] = std::min(height, cabecera[0] + filas_tesela);
+            int lect_ini = std::max(0, cabecera[0] - 1);
+            int lect_fin = std::min(height, cabecera[1] + 1);
+            siguiente++;
             
-            recvcounts[i] = es_ppm ? i_local_rows * width * 3 : i_local_rows * width;
-            displs[i] = es_ppm ? i_start_row * width * 3 : i_start_row * width;
+            MPI_Request peticiones[2];
+            MPI_Isend(cabecera, 2, MPI_INT, trabajador, ETIQUETA_TESELA, MPI_COMM_WORLD, &peticiones[0]);
+            MPI_Isend(MpiWire::desplazar(ctx.imagen_red, static_cast<long long>(lect_ini) * stride, tipo_muestra),
+                      (lect_fin - lect_ini) * stride, tipo_muestra, trabajador, ETIQUETA_TESELA_DATOS,
+                      MPI_COMM_WORLD, &peticiones[1]);
+            envios.push_back(peticiones[0]);
+            envios.push_back(peticiones[1]);
+            pendientes[trabajador]++;
+            return true;
+        };
+        auto enviarFin = [&](int trabajador) {
+            MPI_Request peticion;
+            MPI_Isend(nullptr, 0, MPI_INT, trabajador, ETIQUETA_FIN, MPI_COMM_WORLD, &peticion);
+            envios.push_back(peticion);
+        };
+        
+        for (int w = 1; w < ctx.size; w++) {
+            for (int k = 0; k < TESELAS_EN_VUELO; k++) {
+                enviarTesela(w);
+            }
+            if (pendientes[w] == 0) {
+                enviarFin(w);
+            }
         }
+        
+        // Cada resultado llega con su posición y se recibe directamente en su sitio
+        for (int recibidas = 0; recibidas < num_teselas; recibidas++) {
+            int cabecera[2];
+            MPI_Status estado;
+            MPI_Recv(cabecera, 2, MPI_INT, MPI_ANY_SOURCE, ETIQUETA_RESULTADO, MPI_COMM_WORLD, &estado);
+            int w = estado.MPI_SOURCE;
+            MPI_Recv(MpiWire::desplazar(resultado_red, static_cast<long long>(cabecera[0]) * stride, tipo_muestra),
+                     (cabecera[1] - cabecera[0]) * stride, tipo_muestra, w, ETIQUETA_RESULTADO_DATOS,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            pendientes[w]--;
+            if (!enviarTesela(w) && pendientes[w] == 0) {
+                enviarFin(w);
+            }
+        }
+        MPI_Waitall(static_cast<int>(envios.size()), envios.data(), MPI_STATUSES_IGNORE);
+        
+        memcpy(ctx.imagen_red, resultado_red, muestras * MpiWire::bytesMuestra(tipo_muestra));
+        free(resultado_red);
+    } else {
+        // Trabajador: pedir teselas hasta recibir el aviso de fin
+        int max_filas = filas_tesela + 2;
+        int* tesela = (int*)malloc(max_filas * stride * sizeof(int));
+        int* resultado = (int*)malloc(filas_tesela * stride * sizeof(int));
+        void* tesela_red = MpiWire::reservar(static_cast<long long>(max_filas) * stride, tipo_muestra);
+        void* resultado_red = MpiWire::reservar(static_cast<long long>(filas_tesela) * stride, tipo_muestra);
+        Timer activo, tramo;
+        activo.start();
+        
+        while (true) {
+            int cabecera[2];
+            MPI_Status estado;
+            MPI_Recv(cabecera, 2, MPI_INT, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &estado);
+            if (estado.MPI_TAG == ETIQUETA_FIN) {
+                break;
+            }
+            int lect_ini = std::max(0, cabecera[0] - 1);
+            int lect_fin = std::min(height, cabecera[1] + 1);
+            int filas = cabecera[1] - cabecera[0];
+            int muestras_tesela = (lect_fin - lect_ini) * stride;
+            MPI_Recv(tesela_red, muestras_tesela, tipo_muestra, 0, ETIQUETA_TESELA_DATOS,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            
+            tramo.start();
+            MpiWire::desempaquetar(tesela_red, tesela, muestras_tesela, tipo_muestra);
+            filtrarFilasPropias(resultado, tesela, width, lect_fin - lect_ini, cabecera[0] - lect_ini,
+                                0, filas, es_ppm, ctx.filtro, ctx.max_color);
+            MpiWire::empaquetar(resultado, resultado_red, filas * stride, tipo_muestra);
+            tramo.stop();
+            estadisticas[0] += 1;
+            estadisticas[1] += filas;
+            estadisticas[2] += tramo.getElapsedMilliseconds();
+            
+            MPI_Send(cabecera, 2, MPI_INT, 0, ETIQUETA_RESULTADO, MPI_COMM_WORLD);
+            MPI_Send(resultado_red, filas * stride, tipo_muestra, 0, ETIQUETA_RESULTADO_DATOS, MPI_COMM_WORLD);
+        }
+        activo.stop();
+        estadisticas[3] = activo.getElapsedMilliseconds();
+        
+        free(tesela);
+        free(resultado);
+        free(tesela_red);
+        free(resultado_red);
     }
     
-    MPI_Gatherv(local_result, local_size, MPI_INT,
-                final_result, recvcounts, displs, MPI_INT,
-                0, MPI_COMM_WORLD);
+    timer_filtro.stop();
+    
+    // Rendimiento de cada trabajador para ver el desequilibrio entre nodos
+    double* todas = nullptr;
+    if (rank == 0) {
+        todas = (double*)malloc(4 * ctx.size * sizeof(double));
+    }
+    MPI_Gather(estadisticas, 4, MPI_DOUBLE, todas, 4, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        timer_filtro.printElapsed("Tiempo de filtrado distribuido");
+        std::cout << "Rendimiento por proceso (reparto dinámico):" << std::endl;
+        std::cout << "  Proceso 0: coordinador" << std::endl;
+        double min_filas = height, max_filas = 0;
+        for (int i = 1; i < ctx.size; i++) {
+            double* e = todas + 4 * i;
+            double mpx_s = (e[2] > 0) ? e[1] * width / (e[2] * 1000.0) : 0.0;
+            double ocupacion = (e[3] > 0) ? 100.0 * e[2] / e[3] : 0.0;
+            std::cout << "  Proceso " << i << ": " << (int)e[0] << " teselas, " << (int)e[1] << " filas, cómputo "
+                      << e[2] << " ms, " << mpx_s << " Mpíxeles/s, ocupado " << ocupacion << "%" << std::endl;
+            min_filas = std::min(min_filas, e[1]);
+            max_filas = std::max(max_filas, e[1]);
+        }
+        std::cout << "Filas por trabajador: mínimo " << (int)min_filas << ", máximo " << (int)max_filas
+                  << " (reparto estático: " << (height + trabajadores - 1) / trabajadores << ")" << std::endl;
+        free(todas);
+    }
+}
+
+// Reparto con memoria compartida por nodo: los procesos de un mismo nodo
+// (MPI_Comm_split_type con MPI_COMM_TYPE_SHARED) comparten dos ventanas de
+// MPI_Win_allocate_shared: la franja de entrada del nodo, con sus halos, y la de salida.
+// Solo el líder de cada nodo recibe y envía datos entre nodos; los demás procesos filtran
+// directamente desde la ventana de entrada a la de salida, sin copias propias ni halos.
+void filtrarMemoriaCompartida(const ContextoMPI& ctx, Timer& timer_filtro) {
+    int rank = ctx.rank;
+    int size = ctx.size;
+    int width = ctx.width;
+    int height = ctx.height;
+    int stride = width * ctx.canales;
+    bool es_ppm = ctx.canales == 3;
+    MPI_Datatype tipo_muestra = ctx.tipo_muestra;
+    Timer timer_comunicacion;
+    timer_comunicacion.start();
+    
+    // Procesos del nodo y comunicador de líderes (el proceso 0 es el líder de su nodo y el
+    // primero de los líderes porque la clave es el rango global)
+    MPI_Comm nodo, lideres;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodo);
+    int rank_nodo, locales;
+    MPI_Comm_rank(nodo, &rank_nodo);
+    MPI_Comm_size(nodo, &locales);
+    bool es_lider = (rank_nodo == 0);
+    MPI_Comm_split(MPI_COMM_WORLD, es_lider ? 0 : MPI_UNDEFINED, rank, &lideres);
+    
+    // Cada proceso filtra las mismas filas que en el reparto por filas, numerado por nodos:
+    // el nodo k ocupa los procesos [primero, primero + locales) y su franja es la unión
+    // de sus filas, así los nodos con más procesos reciben más filas
+    int primero = 0;
+    int num_nodos = 1;
+    int rank_lider = 0;
+    if (es_lider) {
+        MPI_Comm_rank(lideres, &rank_lider);
+        MPI_Comm_size(lideres, &num_nodos);
+        MPI_Exscan(&locales, &primero, 1, MPI_INT, MPI_SUM, lideres);
+        if (rank_lider == 0) {
+            primero = 0;
+        }
+    }
+    MPI_Bcast(&primero, 1, MPI_INT, 0, nodo);
+    
+    int nodo_ini, nodo_fin, fila_ini, fila_fin, aux;
+    filasDeProceso(primero, height, size, nodo_ini, aux);
+    filasDeProceso(primero + locales - 1, height, size, aux, nodo_fin);
+    filasDeProceso(primero + rank_nodo, height, size, fila_ini, fila_fin);
+    int filas_nodo = nodo_fin - nodo_ini;
+    int lect_ini = (filas_nodo > 0) ? std::max(0, nodo_ini - 1) : nodo_ini;
+    int lect_fin = (filas_nodo > 0) ? std::min(height, nodo_fin + 1) : nodo_ini;
+    int filas_franja = lect_fin - lect_ini;
+    
+    // Ventanas compartidas: el líder aporta la memoria y el resto obtiene su dirección
+    int* entrada = nullptr;
+    int* salida = nullptr;
+    MPI_Win win_entrada, win_salida;
+    MPI_Aint bytes_entrada = es_lider ? static_cast<MPI_Aint>(filas_franja) * stride * sizeof(int) : 0;
+    MPI_Aint bytes_salida = es_lider ? static_cast<MPI_Aint>(filas_nodo) * stride * sizeof(int) : 0;
+    MPI_Win_allocate_shared(bytes_entrada, sizeof(int), MPI_INFO_NULL, nodo, &entrada, &win_entrada);
+    MPI_Win_allocate_shared(bytes_salida, sizeof(int), MPI_INFO_NULL, nodo, &salida, &win_salida);
+    if (!es_lider) {
+        MPI_Aint tam;
+        int unidad;
+        MPI_Win_shared_query(win_entrada, 0, &tam, &unidad, &entrada);
+        MPI_Win_shared_query(win_salida, 0, &tam, &unidad, &salida);
+    }
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win_entrada);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win_salida);
+    
+    // Entre nodos: el proceso 0 envía a cada líder la franja de su nodo con los halos
+    // (en el tipo de red) y después recoge sus filas con Gatherv
+    const int ETIQUETA_NODO = 30;
+    std::vector<int> rangos;
+    int* counts = nullptr;
+    int* displs = nullptr;
+    long long muestras_enviadas = 0;
+    if (es_lider) {
+        int rango[4] = {lect_ini, lect_fin, nodo_ini, nodo_fin};
+        if (rank_lider == 0) {
+            rangos.resize(4 * num_nodos);
+        }
+        MPI_Gather(rango, 4, MPI_INT, rangos.data(), 4, MPI_INT, 0, lideres);
+        
+        if (rank_lider == 0) {
+            counts = (int*)malloc(num_nodos * sizeof(int));
+            displs = (int*)malloc(num_nodos * sizeof(int));
+            std::vector<MPI_Request> envios(num_nodos, MPI_REQUEST_NULL);
+            for (int k = 0; k < num_nodos; k++) {
+                counts[k] = (rangos[4 * k + 3] - rangos[4 * k + 2]) * stride;
+                displs[k] = rangos[4 * k + 2] * stride;
+                if (k > 0) {
+                    int muestras = (rangos[4 * k + 1] - rangos[4 * k]) * stride;
+                    MPI_Isend(MpiWire::desplazar(ctx.imagen_red, static_cast<long long>(rangos[4 * k]) * stride, tipo_muestra),
+                              muestras, tipo_muestra, k, ETIQUETA_NODO, lideres, &envios[k]);
+                    muestras_enviadas += muestras;
+                }
+            }
+            // La franja del propio nodo se convierte directamente en la ventana
+            MpiWire::desempaquetar(MpiWire::desplazar(ctx.imagen_red, static_cast<long long>(lect_ini) * stride, tipo_muestra),
+                                   entrada, static_cast<long long>(filas_franja) * stride, tipo_muestra);
+            MPI_Waitall(num_nodos, envios.data(), MPI_STATUSES_IGNORE);
+        } else {
+            void* franja_red = MpiWire::reservar(static_cast<long long>(filas_franja) * stride, tipo_muestra);
+            MPI_Recv(franja_red, filas_franja * stride, tipo_muestra, 0, ETIQUETA_NODO, lideres, MPI_STATUS_IGNORE);
+            MpiWire::desempaquetar(franja_red, entrada, static_cast<long long>(filas_franja) * stride, tipo_muestra);
+            free(franja_red);
+        }
+    }
+    
+    // Publicar la ventana de entrada a los procesos del nodo
+    MPI_Win_sync(win_entrada);
+    MPI_Barrier(nodo);
+    MPI_Win_sync(win_entrada);
+    
+    timer_comunicacion.stop();
+    
+    if (rank == 0) {
+        // Sin ventanas, cada proceso recibiría su propia franja y los halos
+        long long muestras_por_filas = 0;
+        for (int i = 1; i < size; i++) {
+            int i_ini, i_fin;
+            filasDeProceso(i, height, size, i_ini, i_fin);
+            muestras_por_filas += static_cast<long long>(i_fin - i_ini) * stride;
+        }
+        int bytes = MpiWire::bytesMuestra(tipo_muestra);
+        timer_comunicacion.printElapsed("Tiempo de comunicación inicial (líderes de nodo)");
+        std::cout << "Nodos: " << num_nodos << " (el del proceso 0 con " << locales << " procesos)" << std::endl;
+        std::cout << "Enviado desde el proceso 0: " << muestras_enviadas * bytes / 1024 << " KB a "
+                  << num_nodos - 1 << " líderes (por filas: " << muestras_por_filas * bytes / 1024
+                  << " KB a " << size - 1 << " procesos)" << std::endl;
+        std::cout << "Ventanas compartidas del nodo 0: entrada " << filas_franja * (long long)stride * sizeof(int) / 1024
+                  << " KB, salida " << filas_nodo * (long long)stride * sizeof(int) / 1024 << " KB" << std::endl;
+        std::cout << std::endl << "Iniciando procesamiento distribuido..." << std::endl;
+    }
+    
+    if (fila_fin > fila_ini) {
+        std::cout << "Proceso " << rank << " procesando filas " << fila_ini << " a " << fila_fin - 1 << std::endl;
+    }
+    
+    // Cada proceso filtra sus filas leyendo de la ventana de entrada y escribiendo en la de
+    // salida; los halos entre procesos del nodo ya están en la ventana
+    Timer timer_computo, timer_espera;
+    timer_filtro.start();
+    timer_computo.start();
+    filtrarFilasPropias(salida + static_cast<long long>(fila_ini - nodo_ini) * stride, entrada, width, filas_franja,
+                        fila_ini - lect_ini, 0, fila_fin - fila_ini, es_ppm, ctx.filtro, ctx.max_color);
+    timer_computo.stop();
+    
+    // El líder no lee la salida hasta que todos los procesos del nodo han terminado
+    timer_espera.start();
+    MPI_Win_sync(win_salida);
+    MPI_Barrier(nodo);
+    MPI_Win_sync(win_salida);
+    timer_espera.stop();
+    timer_filtro.stop();
     
+    if (rank == 0) {
+        timer_filtro.printElapsed("Tiempo de filtrado distribuido");
+        std::cout << "Ventanas compartidas (sin halos entre procesos del nodo):" << std::endl;
+    }
+    imprimirTiemposProcesos(ctx, timer_computo.getElapsedMilliseconds(), timer_espera.getElapsedMilliseconds(),
+                            "espera en la barrera del nodo");
+    
+    // Recoger las filas de cada nodo en el proceso 0
+    timer_comunicacion.reset();
+    timer_comunicacion.start();
+    if (es_lider) {
+        long long muestras_nodo = static_cast<long long>(filas_nodo) * stride;
+        void* salida_red = MpiWire::reservar(muestras_nodo, tipo_muestra);
+        MpiWire::empaquetar(salida, salida_red, muestras_nodo, tipo_muestra);
+        MPI_Gatherv(salida_red, static_cast<int>(muestras_nodo), tipo_muestra,
+                    ctx.imagen_red, counts, displs, tipo_muestra, 0, lideres);
+        free(salida_red);
+    }
     timer_comunicacion.stop();
     
     if (rank == 0) {
         timer_comunicacion.printElapsed("Tiempo de comunicación final");
+    }
+    
+    MPI_Win_unlock_all(win_entrada);
+    MPI_Win_unlock_all(win_salida);
+    MPI_Win_free(&win_entrada);
+    MPI_Win_free(&win_salida);
+    if (lideres != MPI_COMM_NULL) {
+        MPI_Comm_free(&lideres);
+    }
+    MPI_Comm_free(&nodo);
+    free(counts);
+    free(displs);
+}
+
+// Reparto en tubería para imágenes de texto (--stream): el proceso 0 parsea el archivo por
+// franjas y envía cada una con sus halos (MPI_Isend) en cuanto está completa, así los
+// procesos empiezan a filtrar mientras él sigue leyendo. A la vuelta publica una recepción
+// por franja y las escribe en orden según llegan. La franja del proceso 0 es la última
+// del archivo: la filtra después de repartir las demás y es también la última en escribirse.
+int procesarEnTuberia(const char* archivo_entrada, const char* archivo_salida, FilterType filtro,
+                      int rank, int size) {
+    Timer timer_total, timer_parseo;
+    timer_total.start();
+    timer_parseo.start();
+    
+    // El proceso 0 lee la cabecera y abre la salida antes de difundir los metadatos;
+    // width == 0 indica a todos que hubo un error
+    InfoImagen info = {0, 0, 0, 0, 0, 0};
+    FILE* file = nullptr;
+    FILE* output = nullptr;
+    LectorPNM* lector = nullptr;
+    char magic[3] = {0, 0, 0};
+    if (rank == 0) {
+        file = fopen(archivo_entrada, "r");
+        if (file == nullptr) {
+            std::cerr << "Error: No se pudo abrir el archivo " << archivo_entrada << std::endl;
+        } else {
+            lector = new LectorPNM(file);
+            int width, height, max_color;
+            if (!lector->leerMagico(magic) || !lector->leerEntero(width) || !lector->leerEntero(height)
+                || !lector->leerEntero(max_color) || width <= 0 || height <= 0 || max_color <= 0
+                || (strcmp(magic, "P2") != 0 && strcmp(magic, "P3") != 0)) {
+                std::cerr << "Error: Cabecera P2/P3 no válida en " << archivo_entrada << std::endl;
+            } else if ((output = fopen(archivo_salida, "w")) == nullptr) {
+                std::cerr << "Error: No se pudo crear el archivo " << archivo_salida << std::endl;
+            } else {
+                info.width = width;
+                info.height = height;
+                info.max_color = max_color;
+                info.es_ppm = (magic[1] == '3') ? 1 : 0;
+                info.pixel_count = width * height * (info.es_ppm ? 3 : 1);
+                std::cout << "Formato detectado: " << (info.es_ppm ? "PPM (P3)" : "PGM (P2)")
+                          << ", reparto en tubería" << std::endl;
+                std::cout << "Dimensiones: " << width << "x" << height << std::endl;
+            }
+        }
+    }
+    MPI_Bcast(&info, 1, MpiWire::tipoInfoImagen(), 0, MPI_COMM_WORLD);
+    if (info.width == 0) {
+        if (rank == 0) {
+            delete lector;
+            if (file != nullptr) fclose(file);
+        }
+        return 1;
+    }
+    
+    ContextoMPI ctx;
+    ctx.rank = rank;
+    ctx.size = size;
+    ctx.width = info.width;
+    ctx.height = info.height;
+    ctx.max_color = info.max_color;
+    ctx.canales = info.es_ppm ? 3 : 1;
+    ctx.filtro = filtro;
+    ctx.tipo_muestra = MpiWire::tipoMuestra(info.max_color);
+    ctx.imagen_red = nullptr;
+    
+    int width = info.width;
+    int height = info.height;
+    bool es_ppm = info.es_ppm != 0;
+    int stride = width * ctx.canales;
+    MPI_Datatype tipo_muestra = ctx.tipo_muestra;
+    // Los resultados están recortados a [0, max_color] y siempre caben en el tipo estrecho;
+    // una franja de entrada con muestras fuera de rango viaja como MPI_INT con su propia etiqueta
+    const int ETIQUETA_FRANJA = 40;
+    const int ETIQUETA_RESULTADO = 41;
+    const int ETIQUETA_FRANJA_INT = 42;
+    
+    // La franja s del archivo la filtra el proceso (s + 1) % size
+    int franja_propia = (rank + size - 1) % size;
+    int fila_ini, fila_fin;
+    filasDeProceso(franja_propia, height, size, fila_ini, fila_fin);
+    int filas = fila_fin - fila_ini;
+    int lect_ini = (filas > 0) ? std::max(0, fila_ini - 1) : fila_ini;
+    int lect_fin = (filas > 0) ? std::min(height, fila_fin + 1) : fila_ini;
+    int filas_franja = lect_fin - lect_ini;
+    int* local_result = (int*)malloc(std::max(1, filas * stride) * sizeof(int));
+    
+    double computo_ms = 0.0, espera_ms = 0.0;
+    Timer tramo;
+    bool correcto = true;
+    
+    if (rank == 0) {
+        // Toda la imagen se parsea en pixels; cada franja se empaqueta con sus halos al completarse
+        int* pixels = (int*)malloc(static_cast<size_t>(height) * stride * sizeof(int));
+        void* resultado_red = MpiWire::reservar(static_cast<long long>(height) * stride, tipo_muestra);
+        std::vector<void*> franjas_red(size, nullptr);
+        std::vector<MPI_Request> envios(size, MPI_REQUEST_NULL);
+        std::vector<MPI_Request> recepciones(size, MPI_REQUEST_NULL);
+        int filas_leidas = 0;
+        double primer_envio_ms = -1.0;
         
-        std::cout << std::endl << "Guardando resultado..." << std::endl;
+        // Parsear hasta tener n filas completas
+        auto leerHasta = [&](int n) {
+            for (; filas_leidas < n; filas_leidas++) {
+                int* fila = pixels + static_cast<size_t>(filas_leidas) * stride;
+                for (int i = 0; i < stride; i++) {
+                    if (!lector->leerEntero(fila[i])) {
+                        std::cerr << "Error: No se pudieron leer los píxeles de " << archivo_entrada << std::endl;
+                        MPI_Abort(MPI_COMM_WORLD, 1);
+                    }
+                }
+            }
+        };
         
-        // Guardar resultado
-        timer_guardado.start();
+        for (int s = 0; s < size - 1; s++) {
+            int destino = s + 1;
+            int s_ini, s_fin;
+            filasDeProceso(s, height, size, s_ini, s_fin);
+            int s_lect_ini = (s_fin > s_ini) ? std::max(0, s_ini - 1) : s_ini;
+            int s_lect_fin = (s_fin > s_ini) ? std::min(height, s_fin + 1) : s_ini;
+            long long muestras = static_cast<long long>(s_lect_fin - s_lect_ini) * stride;
+            
+            leerHasta(s_lect_fin);
+            const int* origen = pixels + static_cast<size_t>(s_lect_ini) * stride;
+            bool en_rango = MpiWire::muestrasEnRango(origen, muestras, info.max_color);
+            MPI_Datatype tipo_franja = en_rango ? tipo_muestra : MPI_INT;
+            franjas_red[s] = MpiWire::reservar(muestras, tipo_franja);
+            MpiWire::empaquetar(origen, franjas_red[s], muestras, tipo_franja);
+            MPI_Isend(franjas_red[s], static_cast<int>(muestras), tipo_franja, destino,
+                      en_rango ? ETIQUETA_FRANJA : ETIQUETA_FRANJA_INT, MPI_COMM_WORLD, &envios[s]);
+            MPI_Irecv(MpiWire::desplazar(resultado_red, static_cast<long long>(s_ini) * stride, tipo_muestra),
+                      (s_fin - s_ini) * stride, tipo_muestra, destino, ETIQUETA_RESULTADO,
+                      MPI_COMM_WORLD, &recepciones[s]);
+            if (primer_envio_ms < 0) {
+                primer_envio_ms = timer_total.getElapsedMilliseconds();
+            }
+        }
+        leerHasta(height);
+        timer_parseo.stop();
+        
+        // Escritura en orden: cada franja en cuanto llega; la propia se filtra al llegar a ella
+        std::vector<char> texto;
+        std::vector<int> franja_recibida;
+        double primer_resultado_ms = -1.0;
+        if (fprintf(output, "%s\n%d %d\n%d\n", magic, width, height, info.max_color) < 0) {
+            correcto = false;
+        }
+        for (int s = 0; s < size && correcto; s++) {
+            int s_ini, s_fin;
+            filasDeProceso(s, height, size, s_ini, s_fin);
+            size_t muestras = static_cast<size_t>(s_fin - s_ini) * stride;
+            const int* origen;
+            if (s == franja_propia) {
+                tramo.start();
+                filtrarFilasPropias(local_result, pixels + static_cast<size_t>(lect_ini) * stride, width,
+                                    filas_franja, fila_ini - lect_ini, 0, filas, es_ppm, filtro, info.max_color);
+                tramo.stop();
+                computo_ms += tramo.getElapsedMilliseconds();
+                origen = local_result;
+            } else {
+                tramo.start();
+                MPI_Wait(&recepciones[s], MPI_STATUS_IGNORE);
+                tramo.stop();
+                espera_ms += tramo.getElapsedMilliseconds();
+                franja_recibida.resize(std::max<size_t>(1, muestras));
+                MpiWire::desempaquetar(MpiWire::desplazar(resultado_red, static_cast<long long>(s_ini) * stride, tipo_muestra),
+                                       franja_recibida.data(), muestras, tipo_muestra);
+                origen = franja_recibida.data();
+            }
+            correcto = EscritorPNM::escribirMuestras(output, origen, muestras, texto);
+            if (primer_resultado_ms < 0 && muestras > 0) {
+                primer_resultado_ms = timer_total.getElapsedMilliseconds();
+            }
+        }
+        if (!correcto) {
+            std::cerr << "Error guardando imagen " << (es_ppm ? "PPM" : "PGM") << std::endl;
+            // Las franjas pendientes se reciben igualmente para no dejar mensajes sin casar
+        }
+        MPI_Waitall(size, recepciones.data(), MPI_STATUSES_IGNORE);
+        MPI_Waitall(size, envios.data(), MPI_STATUSES_IGNORE);
+        if (fclose(output) != 0) {
+            correcto = false;
+        }
+        timer_total.stop();
+        
+        std::cout << std::endl << "Tubería: parseo y reparto " << timer_parseo.getElapsedMilliseconds()
+                  << " ms, primera franja enviada a los " << primer_envio_ms << " ms" << std::endl;
+        std::cout << "Tiempos de cada proceso (espera = franja recibida; en el 0, resultados pendientes):" << std::endl;
+        imprimirTiemposProcesos(ctx, computo_ms, espera_ms, "espera");
+        
+        std::cout << std::endl << "=== Resumen de Tiempos (Proceso Maestro) ===" << std::endl;
+        timer_parseo.printElapsed("Parseo y reparto");
+        std::cout << "Hasta el primer resultado escrito: " << primer_resultado_ms << " ms" << std::endl;
+        timer_total.printElapsed("Total");
+        if (correcto) {
+            std::cout << "Procesamiento completado exitosamente con " << size << " procesos MPI" << std::endl;
+        }
+        
+        for (int s = 0; s < size; s++) {
+            free(franjas_red[s]);
+        }
+        free(pixels);
+        free(resultado_red);
+        delete lector;
+        fclose(file);
+    } else {
+        // Trabajador: recibir la franja con sus halos, filtrarla y devolverla
+        long long muestras = static_cast<long long>(filas_franja) * stride;
+        int* franja = (int*)malloc(std::max(1LL, muestras) * sizeof(int));
+        void* resultado_red = MpiWire::reservar(static_cast<long long>(filas) * stride, tipo_muestra);
+        
+        // La etiqueta indica con qué tipo viaja la franja
+        tramo.start();
+        MPI_Status estado;
+        MPI_Probe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &estado);
+        MPI_Datatype tipo_franja = (estado.MPI_TAG == ETIQUETA_FRANJA_INT) ? MPI_INT : tipo_muestra;
+        void* franja_red = MpiWire::reservar(muestras, tipo_franja);
+        MPI_Recv(franja_red, static_cast<int>(muestras), tipo_franja, 0, estado.MPI_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        tramo.stop();
+        espera_ms = tramo.getElapsedMilliseconds();
         
-        bool guardado_exitoso = false;
+        tramo.start();
+        MpiWire::desempaquetar(franja_red, franja, muestras, tipo_franja);
+        filtrarFilasPropias(local_result, franja, width, filas_franja, fila_ini - lect_ini,
+                            0, filas, es_ppm, filtro, info.max_color);
+        MpiWire::empaquetar(local_result, resultado_red, static_cast<long long>(filas) * stride, tipo_muestra);
+        tramo.stop();
+        computo_ms = tramo.getElapsedMilliseconds();
         
+        MPI_Send(resultado_red, filas * stride, tipo_muestra, 0, ETIQUETA_RESULTADO, MPI_COMM_WORLD);
+        imprimirTiemposProcesos(ctx, computo_ms, espera_ms, "espera");
+        
+        free(franja);
+        free(franja_red);
+        free(resultado_red);
+    }
+    
+    free(local_result);
+    int resultado = correcto ? 0 : 1;
+    MPI_Bcast(&resultado, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return resultado;
+}
+
+// Contadores de un proceso en la granja de imágenes (solo doubles: se recogen con MPI_DOUBLE)
+struct EstadisticasGranja {
+    double imagenes;
+    double errores;
+    double pixeles;
+    double carga_ms;
+    double filtrado_ms;
+    double guardado_ms;
+    double activo_ms;
+};
+
+// Filtrar una imagen completa en el proceso actual: carga, filtrado y guardado propios
+void filtrarImagenCompleta(const std::string& entrada, const std::string& salida, FilterType filtro,
+                           int rank, EstadisticasGranja& estadisticas) {
+    Timer timer;
+    timer.start();
+    bool es_ppm = esFormatoPPM(entrada.c_str());
+    Imagen* imagen = nullptr;
+    if (es_ppm) {
+        imagen = new PPMImage();
+    } else if (esFormatoPGM(entrada.c_str())) {
+        imagen = new PGMImage();
+    }
+    bool correcto = imagen != nullptr && imagen->cargarImagen(entrada.c_str());
+    timer.stop();
+    estadisticas.carga_ms += timer.getElapsedMilliseconds();
+    
+    Imagen* resultado = nullptr;
+    if (correcto) {
+        timer.start();
         if (es_ppm) {
-            // Cargar imagen original como template
-            PPMImage temp_image;
-            if (temp_image.cargarImagen(archivo_entrada)) {
-                PPMImage* resultado = temp_image.crearImagenVacia();
-                if (resultado != nullptr) {
-                    // Copiar los datos procesados
-                    memcpy(resultado->getPixels(), final_result, pixel_count * sizeof(int));
-                    
-                    if (resultado->guardarImagen(archivo_salida)) {
-                        guardado_exitoso = true;
-                    } else {
-                        std::cerr << "Error guardando imagen PPM" << std::endl;
-                    }
-                    
-                    delete resultado;
+            resultado = Filter::aplicarFiltro(static_cast<PPMImage*>(imagen), filtro);
+        } else {
+            resultado = Filter::aplicarFiltro(static_cast<PGMImage*>(imagen), filtro);
+        }
+        timer.stop();
+        estadisticas.filtrado_ms += timer.getElapsedMilliseconds();
+        correcto = resultado != nullptr;
+    }
+    
+    if (correcto) {
+        estadisticas.pixeles += static_cast<double>(imagen->getWidth()) * imagen->getHeight();
+        timer.start();
+        correcto = resultado->guardarImagen(salida.c_str());
+        timer.stop();
+        estadisticas.guardado_ms += timer.getElapsedMilliseconds();
+    }
+    
+    if (correcto) {
+        estadisticas.imagenes += 1;
+    } else {
+        estadisticas.errores += 1;
+        std::cerr << "Error: El proceso " << rank << " no pudo procesar " << entrada << std::endl;
+    }
+    delete imagen;
+    delete resultado;
+}
+
+// Granja de tareas para lotes de imágenes: cada proceso filtra imágenes completas y las lee y
+// guarda él mismo, sin repartir píxeles. El proceso 0 ordena la lista de mayor a menor tamaño
+// de archivo (así no queda una imagen grande sola al final) y entrega los índices bajo
+// demanda, con dos tareas en vuelo por trabajador como en el reparto dinámico.
+int procesarGranja(const char* ruta_entradas, const char* dir_salida, FilterType filtro, int rank, int size) {
+    // Cada proceso filtra con un solo hilo: la unidad de paralelismo es el proceso
+    ThreadPool::configurarGlobal(1);
+    
+    // El proceso 0 lista y ordena las entradas y difunde la lista ya ordenada
+    std::string lista;
+    int longitud = -1;
+    if (rank == 0) {
+        std::vector<std::string> entradas;
+        if (BatchPipeline::listarEntradas(ruta_entradas, entradas)) {
+            std::vector<std::pair<long long, std::string> > por_tamano;
+            for (size_t i = 0; i < entradas.size(); i++) {
+                struct stat info;
+                long long bytes = (stat(entradas[i].c_str(), &info) == 0) ? static_cast<long long>(info.st_size) : 0;
+                por_tamano.push_back(std::make_pair(bytes, entradas[i]));
+            }
+            std::stable_sort(por_tamano.begin(), por_tamano.end(),
+                             [](const std::pair<long long, std::string>& a, const std::pair<long long, std::string>& b) {
+                                 return a.first > b.first;
+                             });
+            for (size_t i = 0; i < por_tamano.size(); i++) {
+                lista += por_tamano[i].second + "\n";
+            }
+            longitud = static_cast<int>(lista.size());
+            
+            std::cout << "=== Granja de imágenes con MPI (" << size << " procesos) ===" << std::endl;
+            std::cout << "Entradas: " << ruta_entradas << " (" << por_tamano.size() << " imágenes)" << std::endl;
+            std::cout << "Directorio de salida: " << dir_salida << std::endl;
+            std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+            if (!por_tamano.empty()) {
+                std::cout << "Orden: de mayor a menor (" << por_tamano.front().first << " a "
+                          << por_tamano.back().first << " bytes)" << std::endl;
+            }
+            std::cout << std::endl;
+        }
+    }
+    MPI_Bcast(&longitud, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (longitud < 0) {
+        return 1;
+    }
+    lista.resize(longitud);
+    if (longitud > 0) {
+        MPI_Bcast(&lista[0], longitud, MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+    
+    std::vector<std::string> entradas;
+    size_t inicio = 0;
+    for (size_t fin = lista.find('\n'); fin != std::string::npos; fin = lista.find('\n', inicio)) {
+        entradas.push_back(lista.substr(inicio, fin - inicio));
+        inicio = fin + 1;
+    }
+    int num_imagenes = static_cast<int>(entradas.size());
+    
+    const int ETIQUETA_TAREA = 20;
+    const int ETIQUETA_HECHA = 21;
+    const int ETIQUETA_FIN = 22;
+    const int TAREAS_EN_VUELO = 2;
+    
+    EstadisticasGranja estadisticas = {0, 0, 0, 0, 0, 0, 0};
+    Timer timer_total, activo;
+    timer_total.start();
+    activo.start();
+    
+    if (size == 1) {
+        // Sin trabajadores: el único proceso recorre la lista en orden
+        for (int k = 0; k < num_imagenes; k++) {
+            filtrarImagenCompleta(entradas[k], BatchPipeline::construirSalida(entradas[k], dir_salida, filtro),
+                                  filtro, rank, estadisticas);
+        }
+    } else if (rank == 0) {
+        std::vector<int> indices(num_imagenes);
+        std::vector<int> pendientes(size, 0);
+        int siguiente = 0;
+        
+        // Enviar al trabajador el índice de la siguiente imagen; false si no quedan
+        auto enviarTarea = [&](int trabajador) -> bool {
+            if (siguiente >= num_imagenes) {
+                return false;
+            }
+            indices[siguiente] = siguiente;
+            MPI_Send(&indices[siguiente], 1, MPI_INT, trabajador, ETIQUETA_TAREA, MPI_COMM_WORLD);
+            siguiente++;
+            pendientes[trabajador]++;
+            return true;
+        };
+        
+        for (int w = 1; w < size; w++) {
+            for (int k = 0; k < TAREAS_EN_VUELO; k++) {
+                enviarTarea(w);
+            }
+            if (pendientes[w] == 0) {
+                MPI_Send(nullptr, 0, MPI_INT, w, ETIQUETA_FIN, MPI_COMM_WORLD);
+            }
+        }
+        for (int hechas = 0; hechas < num_imagenes; hechas++) {
+            int indice;
+            MPI_Status estado;
+            MPI_Recv(&indice, 1, MPI_INT, MPI_ANY_SOURCE, ETIQUETA_HECHA, MPI_COMM_WORLD, &estado);
+            int w = estado.MPI_SOURCE;
+            pendientes[w]--;
+            if (!enviarTarea(w) && pendientes[w] == 0) {
+                MPI_Send(nullptr, 0, MPI_INT, w, ETIQUETA_FIN, MPI_COMM_WORLD);
+            }
+        }
+    } else {
+        while (true) {
+            int indice;
+            MPI_Status estado;
+            MPI_Recv(&indice, 1, MPI_INT, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &estado);
+            if (estado.MPI_TAG == ETIQUETA_FIN) {
+                break;
+            }
+            filtrarImagenCompleta(entradas[indice],
+                                  BatchPipeline::construirSalida(entradas[indice], dir_salida, filtro),
+                                  filtro, rank, estadisticas);
+            MPI_Send(&indice, 1, MPI_INT, 0, ETIQUETA_HECHA, MPI_COMM_WORLD);
+        }
+    }
+    activo.stop();
+    estadisticas.activo_ms = activo.getElapsedMilliseconds();
+    
+    // Recoger los contadores de todos los procesos
+    const int campos = sizeof(EstadisticasGranja) / sizeof(double);
+    EstadisticasGranja* todas = nullptr;
+    if (rank == 0) {
+        todas = (EstadisticasGranja*)malloc(size * sizeof(EstadisticasGranja));
+    }
+    MPI_Gather(&estadisticas, campos, MPI_DOUBLE, todas, campos, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    timer_total.stop();
+    
+    int errores = 0;
+    if (rank == 0) {
+        int correctas = 0;
+        double trabajo_ms = 0.0;
+        int primero = (size == 1) ? 0 : 1;
+        std::cout << "Rendimiento por proceso:" << std::endl;
+        if (primero == 1) {
+            std::cout << "  Proceso 0: coordinador" << std::endl;
+        }
+        for (int i = primero; i < size; i++) {
+            const EstadisticasGranja& e = todas[i];
+            double ocupado = e.carga_ms + e.filtrado_ms + e.guardado_ms;
+            double por_segundo = (e.activo_ms > 0) ? e.imagenes * 1000.0 / e.activo_ms : 0.0;
+            std::cout << "  Proceso " << i << ": " << (int)e.imagenes << " imágenes";
+            if (e.errores > 0) {
+                std::cout << " (" << (int)e.errores << " errores)";
+            }
+            std::cout << ", " << e.pixeles / 1e6 << " Mpíxeles, carga " << e.carga_ms << " ms, filtrado "
+                      << e.filtrado_ms << " ms, guardado " << e.guardado_ms << " ms, "
+                      << por_segundo << " imágenes/s" << std::endl;
+            correctas += (int)e.imagenes;
+            errores += (int)e.errores;
+            trabajo_ms += ocupado;
+        }
+        
+        double total_ms = timer_total.getElapsedMilliseconds();
+        int trabajadores = size - primero;
+        std::cout << std::endl << "=== Resumen de la Granja ===" << std::endl;
+        std::cout << "Imágenes: " << correctas << " de " << num_imagenes;
+        if (errores > 0) {
+            std::cout << " (" << errores << " errores)";
+        }
+        std::cout << std::endl;
+        timer_total.printElapsed("Total");
+        if (total_ms > 0) {
+            std::cout << "Rendimiento: " << correctas * 1000.0 / total_ms << " imágenes/s" << std::endl;
+            // Trabajo útil frente al tiempo disponible de los trabajadores
+            std::cout << "Eficiencia de los trabajadores: " << 100.0 * trabajo_ms / (total_ms * trabajadores)
+                      << "% (" << trabajo_ms << " ms de trabajo)" << std::endl;
+        }
+        free(todas);
+    }
+    MPI_Bcast(&errores, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return errores == 0 ? 0 : 1;
+}
+
+// Hilos por proceso para --threads auto: los núcleos que ve el proceso, que respetan el
+// binding de mpirun; si los procesos del nodo no están ligados y cada uno vería todos los
+// núcleos, se reparten entre ellos. Colectiva.
+int hilosAutomaticos() {
+    MPI_Comm nodo;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodo);
+    int locales;
+    MPI_Comm_size(nodo, &locales);
+    MPI_Comm_free(&nodo);
+    
+    int visibles = ThreadPool::detectarNumHilos();
+    int nucleos = static_cast<int>(std::thread::hardware_concurrency());
+    if (nucleos > 0 && visibles * locales > nucleos) {
+        visibles = std::max(1, nucleos / locales);
+    }
+    return visibles;
+}
+
+int main(int argc, char* argv[]) {
+    int rank, size;
+    
+    // Solo el hilo principal de cada proceso llama a MPI; los hilos del pool solo filtran
+    int nivel_hilos;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_hilos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    if (argc < 5) {
+        if (rank == 0) {
+            std::cout << "Error: Argumentos insuficientes" << std::endl;
+            mostrarUso(argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    const char* archivo_entrada = argv[1];
+    const char* archivo_salida = argv[2];
+    const char* flag_filtro = argv[3];
+    const char* nombre_filtro = argv[4];
+    
+    // Granja: directorio o manifiesto de imágenes completas repartidas entre los procesos
+    if (strcmp(flag_filtro, "--farm") == 0) {
+        int resultado = procesarGranja(archivo_entrada, archivo_salida,
+                                       Filter::stringToFilterType(nombre_filtro), rank, size);
+        MPI_Finalize();
+        return resultado;
+    }
+    
+    if (strcmp(flag_filtro, "--f") != 0) {
+        if (rank == 0) {
+            std::cout << "Error: Flag de filtro incorrecto. Use --f" << std::endl;
+            mostrarUso(argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    FilterType filtro = Filter::stringToFilterType(nombre_filtro);
+    
+    // Pistas para MPI_File_open (solo en el camino MPI-IO de imágenes binarias)
+    std::vector<std::string> hints;
+    Descomposicion decomp = DECOMP_FILAS;
+    int filas_tesela = 0;   // 0: tamaño automático en el reparto dinámico
+    int hilos = 1;          // Hilos de filtrado por proceso; 0: automático
+    bool en_tuberia = false;
+    for (int i = 5; i < argc; i++) {
+        if (strcmp(argv[i], "--stream") == 0) {
+            en_tuberia = true;
+        } else if (i + 1 >= argc) {
+            // Las demás opciones llevan valor
+            break;
+        } else if (strcmp(argv[i], "--hint") == 0) {
+            hints.push_back(argv[i + 1]);
+        } else if (strcmp(argv[i], "--decomp") == 0) {
+            if (strcmp(argv[i + 1], "2d") == 0) {
+                decomp = DECOMP_2D;
+            } else if (strcmp(argv[i + 1], "dynamic") == 0) {
+                decomp = DECOMP_DINAMICA;
+            } else if (strcmp(argv[i + 1], "shm") == 0) {
+                decomp = DECOMP_SHM;
+            } else if (strcmp(argv[i + 1], "rows") != 0) {
+                if (rank == 0) {
+                    std::cout << "Error: Descomposición no válida: " << argv[i + 1] << " (use rows, 2d, dynamic o shm)" << std::endl;
+                    mostrarUso(argv[0]);
                 }
+                MPI_Finalize();
+                return 1;
             }
-        } else {
-            // Cargar imagen original como template
-            PGMImage temp_image;
-            if (temp_image.cargarImagen(archivo_entrada)) {
-                PGMImage* resultado = temp_image.crearImagenVacia();
-                if (resultado != nullptr) {
-                    // Copiar los datos procesados
-                    memcpy(resultado->getPixels(), final_result, pixel_count * sizeof(int));
-                    
-                    if (resultado->guardarImagen(archivo_salida)) {
-                        guardado_exitoso = true;
-                    } else {
-                        std::cerr << "Error guardando imagen PGM" << std::endl;
-                    }
-                    
-                    delete resultado;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            hilos = (strcmp(argv[i + 1], "auto") == 0) ? 0 : atoi(argv[i + 1]);
+            if (hilos < 0 || (hilos == 0 && strcmp(argv[i + 1], "auto") != 0)) {
+                if (rank == 0) {
+                    std::cout << "Error: --threads espera un número positivo o auto" << std::endl;
+                    mostrarUso(argv[0]);
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--tile") == 0) {
+            filas_tesela = atoi(argv[i + 1]);
+            if (filas_tesela <= 0) {
+                if (rank == 0) {
+                    std::cout << "Error: --tile espera un número de filas positivo" << std::endl;
+                    mostrarUso(argv[0]);
                 }
+                MPI_Finalize();
+                return 1;
             }
         }
+    }
+    
+    if (hilos == 0) {
+        hilos = hilosAutomaticos();
+    }
+    if (hilos > 1 && nivel_hilos < MPI_THREAD_FUNNELED) {
+        if (rank == 0) {
+            std::cout << "Aviso: la biblioteca MPI no admite MPI_THREAD_FUNNELED; se filtra con un hilo por proceso" << std::endl;
+        }
+        hilos = 1;
+    }
+    ThreadPool::configurarGlobal(hilos);
+    
+    // El número de hilos puede diferir entre nodos con --threads auto
+    int total_hilos = 0;
+    MPI_Reduce(&hilos, &total_hilos, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    
+    Timer timer_total, timer_carga, timer_filtro, timer_guardado;
+    
+    if (rank == 0) {
+        std::cout << "=== Filterer con MPI (" << size << " procesos) ===" << std::endl;
+        if (total_hilos > size) {
+            std::cout << "Modo híbrido: " << size << " procesos, " << total_hilos
+                      << " hilos de filtrado en total (MPI_THREAD_FUNNELED)" << std::endl;
+        }
+        std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
+        std::cout << "Archivo de salida: " << archivo_salida << std::endl;
+        std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+        std::cout << "Descomposición: " << (decomp == DECOMP_2D ? "bloques 2D" :
+                                             decomp == DECOMP_DINAMICA ? "dinámica (maestro-trabajador)" :
+                                             decomp == DECOMP_SHM ? "memoria compartida por nodo" :
+                                             "franjas de filas") << std::endl;
+        for (size_t i = 0; i < hints.size(); i++) {
+            std::cout << "Pista MPI-IO: " << hints[i] << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Las imágenes binarias se procesan con E/S paralela; las de texto, desde el proceso 0
+    int es_binario = 0;
+    if (rank == 0) {
+        es_binario = MpiImageIO::esBinario(archivo_entrada) ? 1 : 0;
+    }
+    MPI_Bcast(&es_binario, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (es_binario) {
+        if (decomp != DECOMP_FILAS && rank == 0) {
+            std::cout << "Aviso: --decomp solo se aplica a imágenes de texto; MPI-IO lee franjas de filas" << std::endl;
+        }
+        int resultado = procesarBinarioMPIIO(archivo_entrada, archivo_salida, filtro, hints, rank, size);
+        MPI_Finalize();
+        return resultado;
+    }
+    
+    if (en_tuberia) {
+        if (decomp != DECOMP_FILAS && rank == 0) {
+            std::cout << "Aviso: --stream reparte franjas de filas; se ignora --decomp" << std::endl;
+        }
+        int resultado = procesarEnTuberia(archivo_entrada, archivo_salida, filtro, rank, size);
+        MpiWire::liberarTipos();
+        MPI_Finalize();
+        return resultado;
+    }
+    
+    timer_total.start();
+    
+    // El proceso maestro carga la imagen una sola vez; el mismo objeto recibe al final el
+    // resultado y se guarda, sin volver a parsear la entrada
+    Imagen* imagen = nullptr;
+    InfoImagen info = {0, 0, 0, 0, 0, 0};
+    
+    if (rank == 0) {
+        if (esFormatoPPM(archivo_entrada)) {
+            info.es_ppm = 1;
+            std::cout << "Formato detectado: PPM (P3)" << std::endl;
+            imagen = new PPMImage();
+        } else if (esFormatoPGM(archivo_entrada)) {
+            info.es_ppm = 0;
+            std::cout << "Formato detectado: PGM (P2)" << std::endl;
+            imagen = new PGMImage();
+        } else {
+            std::cerr << "Error: Formato no soportado" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        
+        timer_carga.start();
+        
+        if (!imagen->cargarImagen(archivo_entrada)) {
+            std::cerr << "Error: No se pudo cargar la imagen " << (info.es_ppm ? "PPM" : "PGM") << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        
+        timer_carga.stop();
+        
+        info.width = imagen->getWidth();
+        info.height = imagen->getHeight();
+        info.max_color = imagen->getMaxColor();
+        info.pixel_count = imagen->getPixelCount();
+        info.fuera_de_rango = MpiWire::muestrasEnRango(imagen->getPixels(), info.pixel_count, info.max_color) ? 0 : 1;
+        
+        std::cout << "Dimensiones: " << info.width << "x" << info.height << std::endl;
+        if (info.fuera_de_rango) {
+            std::cout << "Aviso: hay muestras fuera de [0, " << info.max_color << "]; viajan como MPI_INT" << std::endl;
+        }
+        timer_carga.printElapsed("Tiempo de carga");
+    }
+    
+    // Metadatos en un único mensaje con un tipo derivado
+    MPI_Bcast(&info, 1, MpiWire::tipoInfoImagen(), 0, MPI_COMM_WORLD);
+    bool es_ppm = info.es_ppm != 0;
+    
+    ContextoMPI ctx;
+    ctx.rank = rank;
+    ctx.size = size;
+    ctx.width = info.width;
+    ctx.height = info.height;
+    ctx.max_color = info.max_color;
+    ctx.canales = es_ppm ? 3 : 1;
+    ctx.filtro = filtro;
+    // Las muestras viajan con el tipo más estrecho que admite max_color (MPI_INT si alguna se sale)
+    ctx.tipo_muestra = MpiWire::tipoMuestra(info);
+    ctx.imagen_red = nullptr;
+    
+    if (rank == 0) {
+        // La imagen se empaqueta una vez; el mismo buffer recibe después el resultado
+        ctx.imagen_red = MpiWire::reservar(info.pixel_count, ctx.tipo_muestra);
+        MpiWire::empaquetar(imagen->getPixels(), ctx.imagen_red, info.pixel_count, ctx.tipo_muestra);
+        std::cout << "Tipo en la red: " << MpiWire::nombreTipo(ctx.tipo_muestra) << " ("
+                  << (long long)info.pixel_count * MpiWire::bytesMuestra(ctx.tipo_muestra) / 1024
+                  << " KB por reparto; con MPI_INT serían " << (long long)info.pixel_count * sizeof(int) / 1024
+                  << " KB)" << std::endl;
+    }
+    
+    if (decomp == DECOMP_DINAMICA && size == 1) {
+        if (rank == 0) {
+            std::cout << "Aviso: el reparto dinámico necesita al menos un trabajador; se usan franjas de filas" << std::endl;
+        }
+        decomp = DECOMP_FILAS;
+    }
+    
+    if (decomp == DECOMP_2D) {
+        filtrarCartesiano(ctx, timer_filtro);
+    } else if (decomp == DECOMP_DINAMICA) {
+        filtrarDinamico(ctx, filas_tesela, timer_filtro);
+    } else if (decomp == DECOMP_SHM) {
+        filtrarMemoriaCompartida(ctx, timer_filtro);
+    } else {
+        filtrarPorFilas(ctx, timer_filtro);
+    }
+    
+    if (rank == 0) {
+        // El resultado recogido pasa a los píxeles de la imagen cargada
+        MpiWire::desempaquetar(ctx.imagen_red, imagen->getPixels(), info.pixel_count, ctx.tipo_muestra);
+        
+        std::cout << std::endl << "Guardando resultado..." << std::endl;
+        
+        // Guardar resultado: la imagen cargada ya contiene los píxeles filtrados
+        timer_guardado.start();
+        
+        bool guardado_exitoso = imagen->guardarImagen(archivo_salida);
+        if (!guardado_exitoso) {
+            std::cerr << "Error guardando imagen " << (es_ppm ? "PPM" : "PGM") << std::endl;
+        }
         
         timer_guardado.stop();
         
         if (guardado_exitoso) {
             timer_guardado.printElapsed("Tiempo de guardado");
         }
-        
-        free(recvcounts);
-        free(displs);
     }
     
     timer_total.stop();
@@ -446,12 +1968,10 @@ int main(int argc, char* argv[]) {
     }
     
     // Limpiar memoria
-    free(full_image);
-    free(local_result);
-    if (rank == 0 && final_result) {
-        free(final_result);
-    }
+    delete imagen;
+    free(ctx.imagen_red);
     
+    MpiWire::liberarTipos();
     MPI_Finalize();
     return 0;
 }
\ No newline at end of file
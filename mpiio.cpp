@@ -0,0 +1,259 @@
+#include "mpiio.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Bytes que se leen del principio del archivo para parsear la cabecera
+static const int BYTES_CABECERA = 4096;
+
+// Combinar el resultado local de todos los procesos: true solo si todos tuvieron éxito
+static bool todosCorrectos(MPI_Comm comm, bool correcto) {
+    int local = correcto ? 1 : 0;
+    int global = 0;
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LAND, comm);
+    return global != 0;
+}
+
+bool MpiImageIO::esBinario(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == nullptr) return false;
+
+    char magic[3];
+    if (fscanf(file, "%2s", magic) != 1) {
+        fclose(file);
+        return false;
+    }
+
+    fclose(file);
+    return (strcmp(magic, "P5") == 0 || strcmp(magic, "P6") == 0);
+}
+
+MPI_Info MpiImageIO::crearHints(const std::vector<std::string>& hints) {
+    if (hints.empty()) {
+        return MPI_INFO_NULL;
+    }
+
+    MPI_Info info;
+    MPI_Info_create(&info);
+    for (size_t i = 0; i < hints.size(); i++) {
+        size_t igual = hints[i].find('=');
+        if (igual == std::string::npos || igual == 0) {
+            std::cerr << "Aviso: pista MPI-IO ignorada (se espera clave=valor): " << hints[i] << std::endl;
+            continue;
+        }
+        MPI_Info_set(info, hints[i].substr(0, igual).c_str(), hints[i].substr(igual + 1).c_str());
+    }
+    return info;
+}
+
+void MpiImageIO::informarError(MPI_Comm comm, const char* operacion, int codigo) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank != 0) {
+        return;
+    }
+    char mensaje[MPI_MAX_ERROR_STRING];
+    int longitud = 0;
+    MPI_Error_string(codigo, mensaje, &longitud);
+    std::cerr << "Error MPI-IO en " << operacion << ": " << mensaje << std::endl;
+}
+
+bool MpiImageIO::parsearCabecera(const unsigned char* datos, int longitud, CabeceraPNM& cabecera) {
+    if (longitud < 2 || datos[0] != 'P' || (datos[1] != '5' && datos[1] != '6')) {
+        return false;
+    }
+    cabecera.magic[0] = 'P';
+    cabecera.magic[1] = static_cast<char>(datos[1]);
+    cabecera.magic[2] = '\0';
+    cabecera.canales = (datos[1] == '6') ? 3 : 1;
+
+    // Tres enteros (ancho, alto, máximo) separados por espacios y comentarios
+    int valores[3];
+    int pos = 2;
+    for (int v = 0; v < 3; v++) {
+        while (pos < longitud) {
+            if (datos[pos] == '#') {
+                while (pos < longitud && datos[pos] != '\n') pos++;
+            } else if (datos[pos] == ' ' || datos[pos] == '\t' || datos[pos] == '\n' || datos[pos] == '\r') {
+                pos++;
+            } else {
+                break;
+            }
+        }
+        if (pos >= longitud || datos[pos] < '0' || datos[pos] > '9') {
+            return false;
+        }
+        long long numero = 0;
+        while (pos < longitud && datos[pos] >= '0' && datos[pos] <= '9') {
+            numero = numero * 10 + (datos[pos] - '0');
+            if (numero > 0x7fffffff) {
+                return false;
+            }
+            pos++;
+        }
+        valores[v] = static_cast<int>(numero);
+    }
+
+    // Un único carácter de espacio separa la cabecera de los datos binarios
+    if (pos >= longitud) {
+        return false;
+    }
+    cabecera.width = valores[0];
+    cabecera.height = valores[1];
+    cabecera.max_color = valores[2];
+    cabecera.bytes_muestra = (cabecera.max_color < 256) ? 1 : 2;
+    cabecera.inicio_datos = pos + 1;
+    return cabecera.width > 0 && cabecera.height > 0 && cabecera.max_color > 0 && cabecera.max_color < 65536;
+}
+
+bool MpiImageIO::abrirLectura(const char* filename, MPI_Comm comm, MPI_Info info,
+                              MPI_File& archivo, CabeceraPNM& cabecera) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    int codigo = MPI_File_open(comm, filename, MPI_MODE_RDONLY, info, &archivo);
+    if (codigo != MPI_SUCCESS) {
+        informarError(comm, "MPI_File_open", codigo);
+        return false;
+    }
+
+    // El proceso 0 lee y parsea la cabecera; el resto la recibe ya resuelta
+    long long campos[6] = {0, 0, 0, 0, 0, 0};
+    if (rank == 0) {
+        unsigned char datos[BYTES_CABECERA];
+        MPI_Status estado;
+        int leidos = 0;
+        if (MPI_File_read_at(archivo, 0, datos, BYTES_CABECERA, MPI_BYTE, &estado) == MPI_SUCCESS) {
+            MPI_Get_count(&estado, MPI_BYTE, &leidos);
+        }
+        CabeceraPNM leida;
+        if (parsearCabecera(datos, leidos, leida)) {
+            campos[0] = leida.magic[1];
+            campos[1] = leida.width;
+            campos[2] = leida.height;
+            campos[3] = leida.max_color;
+            campos[4] = leida.inicio_datos;
+            campos[5] = 1;
+        } else {
+            std::cerr << "Error: Cabecera P5/P6 no válida en " << filename << std::endl;
+        }
+    }
+    MPI_Bcast(campos, 6, MPI_LONG_LONG, 0, comm);
+
+    if (campos[5] == 0) {
+        MPI_File_close(&archivo);
+        return false;
+    }
+
+    cabecera.magic[0] = 'P';
+    cabecera.magic[1] = static_cast<char>(campos[0]);
+    cabecera.magic[2] = '\0';
+    cabecera.canales = (cabecera.magic[1] == '6') ? 3 : 1;
+    cabecera.width = static_cast<int>(campos[1]);
+    cabecera.height = static_cast<int>(campos[2]);
+    cabecera.max_color = static_cast<int>(campos[3]);
+    cabecera.bytes_muestra = (cabecera.max_color < 256) ? 1 : 2;
+    cabecera.inicio_datos = campos[4];
+    return true;
+}
+
+bool MpiImageIO::leerFilas(MPI_File archivo, MPI_Comm comm, const CabeceraPNM& cabecera,
+                           int fila_ini, int fila_fin, int* destino) {
+    int filas = std::max(0, fila_fin - fila_ini);
+    long long bytes = filas * cabecera.bytesFila();
+    unsigned char* buffer = (unsigned char*)malloc(bytes > 0 ? bytes : 1);
+    if (buffer == nullptr) {
+        std::cerr << "Error: No se pudo reservar memoria para la lectura MPI-IO" << std::endl;
+        MPI_Abort(comm, 1);
+    }
+
+    MPI_Offset desplazamiento = cabecera.inicio_datos + fila_ini * cabecera.bytesFila();
+    MPI_Status estado;
+    int codigo = MPI_File_read_at_all(archivo, desplazamiento, buffer, static_cast<int>(bytes),
+                                      MPI_BYTE, &estado);
+    int leidos = 0;
+    if (codigo == MPI_SUCCESS) {
+        MPI_Get_count(&estado, MPI_BYTE, &leidos);
+    }
+    bool correcto = (codigo == MPI_SUCCESS && leidos == bytes);
+
+    if (correcto) {
+        long long muestras = bytes / cabecera.bytes_muestra;
+        if (cabecera.bytes_muestra == 1) {
+            for (long long i = 0; i < muestras; i++) {
+                destino[i] = buffer[i];
+            }
+        } else {
+            for (long long i = 0; i < muestras; i++) {
+                destino[i] = (buffer[2 * i] << 8) | buffer[2 * i + 1];
+            }
+        }
+    }
+    free(buffer);
+    return todosCorrectos(comm, correcto);
+}
+
+bool MpiImageIO::abrirEscritura(const char* filename, MPI_Comm comm, MPI_Info info,
+                                const CabeceraPNM& cabecera, MPI_File& archivo,
+                                CabeceraPNM& cabecera_salida) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Todos los procesos generan la misma cabecera, así conocen dónde empiezan los datos
+    char texto[64];
+    int longitud = snprintf(texto, sizeof(texto), "%s\n%d %d\n%d\n", cabecera.magic,
+                            cabecera.width, cabecera.height, cabecera.max_color);
+    cabecera_salida = cabecera;
+    cabecera_salida.inicio_datos = longitud;
+
+    int codigo = MPI_File_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &archivo);
+    if (codigo != MPI_SUCCESS) {
+        informarError(comm, "MPI_File_open", codigo);
+        return false;
+    }
+
+    // Tamaño final exacto (trunca un archivo anterior más grande)
+    MPI_Offset total = longitud + cabecera.height * cabecera.bytesFila();
+    codigo = MPI_File_set_size(archivo, total);
+    bool correcto = (codigo == MPI_SUCCESS);
+    if (correcto && rank == 0) {
+        correcto = MPI_File_write_at(archivo, 0, texto, longitud, MPI_CHAR, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+    }
+    if (!todosCorrectos(comm, correcto)) {
+        informarError(comm, "la cabecera de salida", codigo);
+        MPI_File_close(&archivo);
+        return false;
+    }
+    return true;
+}
+
+bool MpiImageIO::escribirFilas(MPI_File archivo, MPI_Comm comm, const CabeceraPNM& cabecera,
+                               int fila_ini, int fila_fin, const int* origen) {
+    int filas = std::max(0, fila_fin - fila_ini);
+    long long bytes = filas * cabecera.bytesFila();
+    unsigned char* buffer = (unsigned char*)malloc(bytes > 0 ? bytes : 1);
+    if (buffer == nullptr) {
+        std::cerr << "Error: No se pudo reservar memoria para la escritura MPI-IO" << std::endl;
+        MPI_Abort(comm, 1);
+    }
+
+    long long muestras = bytes / cabecera.bytes_muestra;
+    if (cabecera.bytes_muestra == 1) {
+        for (long long i = 0; i < muestras; i++) {
+            buffer[i] = static_cast<unsigned char>(origen[i]);
+        }
+    } else {
+        for (long long i = 0; i < muestras; i++) {
+            buffer[2 * i] = static_cast<unsigned char>(origen[i] >> 8);
+            buffer[2 * i + 1] = static_cast<unsigned char>(origen[i] & 0xff);
+        }
+    }
+
+    MPI_Offset desplazamiento = cabecera.inicio_datos + fila_ini * cabecera.bytesFila();
+    int codigo = MPI_File_write_at_all(archivo, desplazamiento, buffer, static_cast<int>(bytes),
+                                       MPI_BYTE, MPI_STATUS_IGNORE);
+    free(buffer);
+    return todosCorrectos(comm, codigo == MPI_SUCCESS);
+}
\ No newline at end of file
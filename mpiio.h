@@ -0,0 +1,63 @@
+#ifndef MPIIO_H
+#define MPIIO_H
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+// Cabecera de una imagen binaria PGM (P5) o PPM (P6)
+struct CabeceraPNM {
+    char magic[3];
+    int width;
+    int height;
+    int max_color;
+    int canales;          // 1 para P5, 3 para P6
+    int bytes_muestra;    // 1 si max_color < 256, 2 (big-endian) en otro caso
+    long long inicio_datos;   // Desplazamiento en bytes del primer píxel
+
+    // Bytes de una fila completa en el archivo
+    long long bytesFila() const { return static_cast<long long>(width) * canales * bytes_muestra; }
+};
+
+// Lectura y escritura paralela de imágenes binarias con MPI-IO: cada proceso calcula
+// a partir de la cabecera el desplazamiento de sus filas y las lee o escribe con
+// operaciones colectivas (MPI_File_read_at_all / MPI_File_write_at_all).
+class MpiImageIO {
+public:
+    // true si el archivo es P5 o P6 (solo se comprueba el número mágico)
+    static bool esBinario(const char* filename);
+
+    // Crear un MPI_Info con pistas "clave=valor" (p. ej. romio_cb_read=enable, cb_nodes=4,
+    // cb_buffer_size=16777216). Devuelve MPI_INFO_NULL si no hay pistas; el llamador lo libera.
+    static MPI_Info crearHints(const std::vector<std::string>& hints);
+
+    // Abrir el archivo en todos los procesos y leer la cabecera (la parsea el proceso 0 y
+    // la difunde). Colectiva; false en todos los procesos si falla.
+    static bool abrirLectura(const char* filename, MPI_Comm comm, MPI_Info info,
+                             MPI_File& archivo, CabeceraPNM& cabecera);
+
+    // Leer las filas [fila_ini, fila_fin) en destino (enteros, canales intercalados).
+    // Colectiva: los procesos sin filas participan con un rango vacío. El resultado
+    // es el mismo en todos los procesos (false si alguno falló).
+    static bool leerFilas(MPI_File archivo, MPI_Comm comm, const CabeceraPNM& cabecera,
+                          int fila_ini, int fila_fin, int* destino);
+
+    // Crear el archivo de salida con la misma cabecera y tamaño final (el proceso 0
+    // escribe la cabecera). Colectiva; devuelve en cabecera_salida la cabecera escrita.
+    static bool abrirEscritura(const char* filename, MPI_Comm comm, MPI_Info info,
+                               const CabeceraPNM& cabecera, MPI_File& archivo,
+                               CabeceraPNM& cabecera_salida);
+
+    // Escribir las filas [fila_ini, fila_fin) desde origen. Colectiva, como leerFilas.
+    static bool escribirFilas(MPI_File archivo, MPI_Comm comm, const CabeceraPNM& cabecera,
+                              int fila_ini, int fila_fin, const int* origen);
+
+private:
+    // Parsear la cabecera a partir de los primeros bytes del archivo
+    static bool parsearCabecera(const unsigned char* datos, int longitud, CabeceraPNM& cabecera);
+
+    // Informar de un error MPI-IO (solo el proceso 0 lo imprime)
+    static void informarError(MPI_Comm comm, const char* operacion, int codigo);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "mpiwire.h"
+#include <cstddef>
+#include <cstdlib>
+
+MPI_Datatype MpiWire::tipo_info = MPI_DATATYPE_NULL;
+
+MPI_Datatype MpiWire::tipoMuestra(int max_color) {
+    if (max_color <= 0xff) {
+        return MPI_UNSIGNED_CHAR;
+    }
+    if (max_color <= 0xffff) {
+        return MPI_UNSIGNED_SHORT;
+    }
+    return MPI_INT;
+}
+
+MPI_Datatype MpiWire::tipoMuestra(const InfoImagen& info) {
+    return info.fuera_de_rango ? MPI_INT : tipoMuestra(info.max_color);
+}
+
+bool MpiWire::muestrasEnRango(const int* muestras, long long n, int max_color) {
+    for (long long i = 0; i < n; i++) {
+        if (muestras[i] < 0 || muestras[i] > max_color) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MpiWire::bytesMuestra(MPI_Datatype tipo) {
+    if (tipo == MPI_UNSIGNED_CHAR) {
+        return 1;
+    }
+    if (tipo == MPI_UNSIGNED_SHORT) {
+        return 2;
+    }
+    return 4;
+}
+
+const char* MpiWire::nombreTipo(MPI_Datatype tipo) {
+    if (tipo == MPI_UNSIGNED_CHAR) {
+        return "MPI_UNSIGNED_CHAR";
+    }
+    if (tipo == MPI_UNSIGNED_SHORT) {
+        return "MPI_UNSIGNED_SHORT";
+    }
+    return "MPI_INT";
+}
+
+void* MpiWire::reservar(long long muestras, MPI_Datatype tipo) {
+    long long bytes = muestras * bytesMuestra(tipo);
+    return malloc(bytes > 0 ? bytes : 1);
+}
+
+void* MpiWire::desplazar(void* buffer, long long muestras, MPI_Datatype tipo) {
+    return static_cast<unsigned char*>(buffer) + muestras * bytesMuestra(tipo);
+}
+
+void MpiWire::empaquetar(const int* origen, void* destino, long long n, MPI_Datatype tipo) {
+    if (tipo == MPI_UNSIGNED_CHAR) {
+        unsigned char* d = static_cast<unsigned char*>(destino);
+        for (long long i = 0; i < n; i++) {
+            d[i] = static_cast<unsigned char>(origen[i]);
+        }
+    } else if (tipo == MPI_UNSIGNED_SHORT) {
+        unsigned short* d = static_cast<unsigned short*>(destino);
+        for (long long i = 0; i < n; i++) {
+            d[i] = static_cast<unsigned short>(origen[i]);
+        }
+    } else {
+        int* d = static_cast<int*>(destino);
+        for (long long i = 0; i < n; i++) {
+            d[i] = origen[i];
+        }
+    }
+}
+
+void MpiWire::desempaquetar(const void* origen, int* destino, long long n, MPI_Datatype tipo) {
+    if (tipo == MPI_UNSIGNED_CHAR) {
+        const unsigned char* o = static_cast<const unsigned char*>(origen);
+        for (long long i = 0; i < n; i++) {
+            destino[i] = o[i];
+        }
+    } else if (tipo == MPI_UNSIGNED_SHORT) {
+        const unsigned short* o = static_cast<const unsigned short*>(origen);
+        for (long long i = 0; i < n; i++) {
+            destino[i] = o[i];
+        }
+    } else {
+        const int* o = static_cast<const int*>(origen);
+        for (long long i = 0; i < n; i++) {
+            destino[i] = o[i];
+        }
+    }
+}
+
+MPI_Datatype MpiWire::tipoInfoImagen() {
+    if (tipo_info != MPI_DATATYPE_NULL) {
+        return tipo_info;
+    }
+
+    // Un campo int por miembro, en su desplazamiento real dentro del struct
+    int longitudes[6] = {1, 1, 1, 1, 1, 1};
+    MPI_Aint desplazamientos[6] = {
+        offsetof(InfoImagen, width), offsetof(InfoImagen, height), offsetof(InfoImagen, max_color),
+        offsetof(InfoImagen, pixel_count), offsetof(InfoImagen, es_ppm), offsetof(InfoImagen, fuera_de_rango)
+    };
+    MPI_Datatype tipos[6] = {MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_INT};
+    MPI_Datatype tipo_struct;
+    MPI_Type_create_struct(6, longitudes, desplazamientos, tipos, &tipo_struct);
+
+    // Ajustar la extensión al tamaño del struct por si el compilador añade relleno
+    MPI_Type_create_resized(tipo_struct, 0, sizeof(InfoImagen), &tipo_info);
+    MPI_Type_free(&tipo_struct);
+    MPI_Type_commit(&tipo_info);
+    return tipo_info;
+}
+
+void MpiWire::liberarTipos() {
+    if (tipo_info != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&tipo_info);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef MPIWIRE_H
+#define MPIWIRE_H
+
+#include <mpi.h>
+
+// Metadatos de la imagen que el proceso 0 difunde en un único mensaje
+struct InfoImagen {
+    int width;
+    int height;
+    int max_color;
+    int pixel_count;
+    int es_ppm;
+    int fuera_de_rango;   // 1 si alguna muestra se sale de [0, max_color]
+};
+
+// Representación compacta de los píxeles en la red: las imágenes se guardan como int,
+// pero las muestras caben en 8 o 16 bits según max_color. Los procesos convierten
+// al enviar y al recibir, y los mensajes viajan con el tipo estrecho.
+class MpiWire {
+public:
+    // Tipo MPI más estrecho que representa muestras en [0, max_color]:
+    // MPI_UNSIGNED_CHAR, MPI_UNSIGNED_SHORT o MPI_INT
+    static MPI_Datatype tipoMuestra(int max_color);
+
+    // Tipo de red para las muestras de la imagen: los cargadores de texto no recortan los
+    // valores, así que si alguno se sale de [0, max_color] se usa MPI_INT para no truncarlo
+    static MPI_Datatype tipoMuestra(const InfoImagen& info);
+
+    // true si las n muestras están en [0, max_color]
+    static bool muestrasEnRango(const int* muestras, long long n, int max_color);
+
+    // Bytes por muestra del tipo devuelto por tipoMuestra
+    static int bytesMuestra(MPI_Datatype tipo);
+
+    // Nombre del tipo para los mensajes del programa
+    static const char* nombreTipo(MPI_Datatype tipo);
+
+    // Reservar un buffer de "muestras" elementos del tipo (al menos un byte)
+    static void* reservar(long long muestras, MPI_Datatype tipo);
+
+    // Convertir n muestras int al tipo de red y viceversa
+    static void empaquetar(const int* origen, void* destino, long long n, MPI_Datatype tipo);
+    static void desempaquetar(const void* origen, int* destino, long long n, MPI_Datatype tipo);
+
+    // Desplazar un puntero a buffer de red en "muestras" elementos del tipo
+    static void* desplazar(void* buffer, long long muestras, MPI_Datatype tipo);
+
+    // Tipo derivado con la disposición de InfoImagen (se crea y confirma una vez)
+    static MPI_Datatype tipoInfoImagen();
+
+    // Liberar los tipos derivados creados (antes de MPI_Finalize)
+    static void liberarTipos();
+
+private:
+    static MPI_Datatype tipo_info;
+};
+
+#endif
\ No newline at end of file
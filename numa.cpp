@@ -0,0 +1,275 @@
+#include "numa.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Leer una lista de CPUs en formato sysfs ("0-3,8-11")
+static std::vector<int> leerListaCpus(const char* ruta) {
+    std::vector<int> cpus;
+    FILE* file = fopen(ruta, "r");
+    if (file == nullptr) {
+        return cpus;
+    }
+
+    char linea[4096];
+    if (fgets(linea, sizeof(linea), file) != nullptr) {
+        char* resto = linea;
+        char* tramo;
+        while ((tramo = strtok(resto, ",\n")) != nullptr) {
+            resto = nullptr;
+            int ini, fin;
+            if (sscanf(tramo, "%d-%d", &ini, &fin) == 2) {
+                for (int c = ini; c <= fin; c++) {
+                    cpus.push_back(c);
+                }
+            } else if (sscanf(tramo, "%d", &ini) == 1) {
+                cpus.push_back(ini);
+            }
+        }
+    }
+
+    fclose(file);
+    return cpus;
+}
+
+static NumaTopology detectarTopologia() {
+    NumaTopology topo;
+    topo.num_nodos = 0;
+
+    // Los nodos pueden no ser consecutivos; se recorren los que sysfs declara en línea
+    std::vector<int> nodos = leerListaCpus("/sys/devices/system/node/online");
+    int max_cpu = -1;
+    for (size_t i = 0; i < nodos.size(); i++) {
+        char ruta[128];
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/node/node%d/cpulist", nodos[i]);
+        std::vector<int> cpus = leerListaCpus(ruta);
+        if (cpus.empty()) {
+            continue;   // Nodo solo de memoria
+        }
+        topo.cpus_por_nodo.push_back(cpus);
+        for (size_t j = 0; j < cpus.size(); j++) {
+            max_cpu = std::max(max_cpu, cpus[j]);
+        }
+    }
+
+    if (topo.cpus_por_nodo.empty()) {
+        // Sin información NUMA: un único nodo con todas las CPUs
+        int hw = static_cast<int>(std::thread::hardware_concurrency());
+        std::vector<int> cpus;
+        for (int c = 0; c < std::max(1, hw); c++) {
+            cpus.push_back(c);
+        }
+        topo.cpus_por_nodo.push_back(cpus);
+        max_cpu = static_cast<int>(cpus.size()) - 1;
+    }
+
+    topo.num_nodos = static_cast<int>(topo.cpus_por_nodo.size());
+    topo.nodo_de_cpu.assign(max_cpu + 1, -1);
+    for (int n = 0; n < topo.num_nodos; n++) {
+        for (size_t j = 0; j < topo.cpus_por_nodo[n].size(); j++) {
+            topo.nodo_de_cpu[topo.cpus_por_nodo[n][j]] = n;
+        }
+    }
+    return topo;
+}
+
+const NumaTopology& Numa::topologia() {
+    static NumaTopology topo = detectarTopologia();
+    return topo;
+}
+
+int Numa::nodoActual() {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    const NumaTopology& topo = topologia();
+    if (cpu >= 0 && cpu < static_cast<int>(topo.nodo_de_cpu.size()) && topo.nodo_de_cpu[cpu] >= 0) {
+        return topo.nodo_de_cpu[cpu];
+    }
+#endif
+    return 0;
+}
+
+std::vector<int> Numa::asignarCpus(PinPolicy politica, int num_hilos) {
+    std::vector<int> asignacion(num_hilos, -1);
+    if (politica == PIN_NONE) {
+        return asignacion;
+    }
+
+    // Solo se usan CPUs permitidas por la afinidad del proceso
+    const NumaTopology& topo = topologia();
+    std::vector<std::vector<int> > disponibles(topo.num_nodos);
+#ifdef __linux__
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    bool hay_afinidad = sched_getaffinity(0, sizeof(permitidas), &permitidas) == 0;
+#endif
+    int total = 0;
+    for (int n = 0; n < topo.num_nodos; n++) {
+        for (size_t j = 0; j < topo.cpus_por_nodo[n].size(); j++) {
+            int cpu = topo.cpus_por_nodo[n][j];
+#ifdef __linux__
+            if (hay_afinidad && (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &permitidas))) {
+                continue;
+            }
+#endif
+            disponibles[n].push_back(cpu);
+            total++;
+        }
+    }
+    if (total == 0) {
+        return asignacion;
+    }
+
+    if (politica == PIN_COMPACT) {
+        std::vector<int> orden;
+        for (int n = 0; n < topo.num_nodos; n++) {
+            orden.insert(orden.end(), disponibles[n].begin(), disponibles[n].end());
+        }
+        for (int i = 0; i < num_hilos; i++) {
+            asignacion[i] = orden[i % orden.size()];
+        }
+    } else {
+        // Scatter: hilo i al nodo i % nodos, tomando la siguiente CPU libre de ese nodo
+        std::vector<size_t> siguiente(topo.num_nodos, 0);
+        int nodo = 0;
+        for (int i = 0; i < num_hilos; i++) {
+            while (disponibles[nodo].empty()) {
+                nodo = (nodo + 1) % topo.num_nodos;
+            }
+            asignacion[i] = disponibles[nodo][siguiente[nodo]++ % disponibles[nodo].size()];
+            nodo = (nodo + 1) % topo.num_nodos;
+        }
+    }
+
+    return asignacion;
+}
+
+bool Numa::fijarPool(ThreadPool& pool, PinPolicy politica) {
+    std::vector<int> cpus = asignarCpus(politica, pool.getNumHilos());
+    if (politica == PIN_NONE) {
+        return true;
+    }
+
+    std::vector<char> correcto(pool.getNumHilos(), 1);
+#ifdef __linux__
+    pool.ejecutar([&](int id, int) {
+        if (cpus[id] < 0) {
+            correcto[id] = 0;
+            return;
+        }
+        cpu_set_t conjunto;
+        CPU_ZERO(&conjunto);
+        CPU_SET(cpus[id], &conjunto);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto) != 0) {
+            correcto[id] = 0;
+        }
+    });
+#endif
+
+    for (size_t i = 0; i < correcto.size(); i++) {
+        if (!correcto[i]) {
+            std::cerr << "Advertencia: no se pudo fijar el thread " << i << " a la CPU " << cpus[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int Numa::nodoDePagina(const void* dir) {
+#if defined(__linux__) && defined(SYS_move_pages)
+    // move_pages sin nodos destino solo consulta dónde está cada página
+    void* pagina = const_cast<void*>(dir);
+    int estado = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &pagina, nullptr, &estado, 0) == 0 && estado >= 0) {
+        return estado;
+    }
+#else
+    (void)dir;
+#endif
+    return -1;
+}
+
+long long Numa::bytesRemotos(const void* dir, long long bytes, int nodo) {
+    if (bytes <= 0 || topologia().num_nodos < 2) {
+        return 0;
+    }
+
+#if defined(__linux__) && defined(SYS_move_pages)
+    const long tam_pagina = sysconf(_SC_PAGESIZE);
+    uintptr_t inicio = reinterpret_cast<uintptr_t>(dir);
+    uintptr_t fin = inicio + static_cast<uintptr_t>(bytes);
+    uintptr_t primera = inicio & ~static_cast<uintptr_t>(tam_pagina - 1);
+
+    std::vector<void*> paginas;
+    for (uintptr_t p = primera; p < fin; p += tam_pagina) {
+        paginas.push_back(reinterpret_cast<void*>(p));
+    }
+    std::vector<int> estados(paginas.size(), -1);
+    if (syscall(SYS_move_pages, 0, paginas.size(), paginas.data(), nullptr, estados.data(), 0) != 0) {
+        return 0;
+    }
+
+    // Contar solo la parte de cada página que cae dentro del rango
+    long long remotos = 0;
+    for (size_t i = 0; i < paginas.size(); i++) {
+        if (estados[i] < 0 || estados[i] == nodo) {
+            continue;
+        }
+        uintptr_t p_ini = std::max(reinterpret_cast<uintptr_t>(paginas[i]), inicio);
+        uintptr_t p_fin = std::min(reinterpret_cast<uintptr_t>(paginas[i]) + tam_pagina, fin);
+        remotos += static_cast<long long>(p_fin - p_ini);
+    }
+    return remotos;
+#else
+    (void)dir;
+    (void)nodo;
+    return 0;
+#endif
+}
+
+int* Numa::primerContacto(BandScheduler& planificador, const int* origen, int alto, int stride) {
+    int* destino = (int*)malloc(static_cast<size_t>(alto) * stride * sizeof(int));
+    if (destino == nullptr) {
+        return nullptr;
+    }
+
+    planificador.recorrerReparto(alto, [&](int fila_ini, int fila_fin, int) {
+        size_t bytes = static_cast<size_t>(fila_fin - fila_ini) * stride * sizeof(int);
+        if (origen != nullptr) {
+            memcpy(destino + static_cast<size_t>(fila_ini) * stride, origen + static_cast<size_t>(fila_ini) * stride, bytes);
+        } else {
+            memset(destino + static_cast<size_t>(fila_ini) * stride, 0, bytes);
+        }
+    });
+
+    return destino;
+}
+
+PinPolicy Numa::stringToPinPolicy(const char* nombre) {
+    if (strcmp(nombre, "compact") == 0) {
+        return PIN_COMPACT;
+    } else if (strcmp(nombre, "scatter") == 0) {
+        return PIN_SCATTER;
+    }
+    return PIN_NONE; // Por defecto
+}
+
+const char* Numa::pinPolicyToString(PinPolicy politica) {
+    switch (politica) {
+        case PIN_NONE: return "none";
+        case PIN_COMPACT: return "compact";
+        case PIN_SCATTER: return "scatter";
+        default: return "unknown";
+    }
+}
\ No newline at end of file
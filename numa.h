@@ -0,0 +1,52 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <vector>
+#include "scheduler.h"
+#include "threadpool.h"
+
+enum PinPolicy {
+    PIN_NONE,      // Sin fijar: el SO decide dónde corre cada hilo
+    PIN_COMPACT,   // Llenar los núcleos de un nodo antes de pasar al siguiente
+    PIN_SCATTER    // Repartir los hilos por turnos entre nodos
+};
+
+// Topología NUMA leída de /sys/devices/system/node (sin depender de libnuma)
+struct NumaTopology {
+    int num_nodos;
+    std::vector<std::vector<int> > cpus_por_nodo;   // CPUs de cada nodo
+    std::vector<int> nodo_de_cpu;                    // Nodo de cada CPU (-1 si no se conoce)
+};
+
+class Numa {
+public:
+    // Topología del sistema (se lee una vez); sin sysfs se asume un único nodo
+    static const NumaTopology& topologia();
+
+    // Nodo de la CPU en la que corre el hilo actual (0 si no se puede saber)
+    static int nodoActual();
+
+    // CPU asignada a cada uno de los num_hilos hilos según la política (-1 = sin fijar)
+    static std::vector<int> asignarCpus(PinPolicy politica, int num_hilos);
+
+    // Fijar cada hilo del pool a su CPU según la política; false si alguna falla
+    static bool fijarPool(ThreadPool& pool, PinPolicy politica);
+
+    // Nodo donde reside la página que contiene dir (-1 si no está en memoria o no se puede saber)
+    static int nodoDePagina(const void* dir);
+
+    // Bytes de [dir, dir + bytes) que residen en un nodo distinto de "nodo"
+    static long long bytesRemotos(const void* dir, long long bytes, int nodo);
+
+    // Primer contacto en paralelo: reservar un buffer de alto * stride enteros y copiar en él
+    // "origen" (o ponerlo a cero si es nullptr). Cada hilo escribe las bandas que el planificador
+    // le asigna inicialmente, así las páginas quedan en el nodo del hilo que las procesará.
+    // El llamador libera el buffer con free(); nullptr si falla la reserva.
+    static int* primerContacto(BandScheduler& planificador, const int* origen, int alto, int stride);
+
+    // Conversión de string a PinPolicy
+    static PinPolicy stringToPinPolicy(const char* nombre);
+    static const char* pinPolicyToString(PinPolicy politica);
+};
+
+#endif
\ No newline at end of file
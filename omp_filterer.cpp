@@ -1,17 +1,53 @@
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <cstdlib>
 #include <string>
+#include <vector>
 #include <omp.h>
 #include "PGMimage.h"
 #include "PPMimage.h"
+#include "asyncwriter.h"
 #include "filter.h"
 #include "timer.h"
 
+// Estrategias de reparto del trabajo entre hilos OpenMP
+enum ModoOMP {
+    MODO_FILTROS,     // Un hilo por filtro (3 hilos, versión original)
+    MODO_FILAS,       // Filtros uno tras otro, filas repartidas dentro de Filter::aplicarFiltro
+    MODO_COLAPSADO    // collapse(2) sobre (filtro, fila): los 3 filtros comparten todos los hilos
+};
+
+ModoOMP stringToModo(const char* nombre) {
+    if (strcmp(nombre, "filtros") == 0) {
+        return MODO_FILTROS;
+    } else if (strcmp(nombre, "filas") == 0) {
+        return MODO_FILAS;
+    }
+    return MODO_COLAPSADO; // Por defecto
+}
+
+const char* modoToString(ModoOMP modo) {
+    switch (modo) {
+        case MODO_FILTROS: return "filtros";
+        case MODO_FILAS: return "filas";
+        case MODO_COLAPSADO: return "colapsado";
+        default: return "unknown";
+    }
+}
+
 void mostrarUso(const char* programa) {
-    std::cout << "Uso: " << programa << " <imagen_entrada>" << std::endl;
+    std::cout << "Uso: " << programa << " <imagen_entrada> [--threads <n>] [--modo <modo>] [--schedule <tipo>]" << std::endl;
     std::cout << "Ejemplo:" << std::endl;
     std::cout << "  " << programa << " sulfur.pgm" << std::endl;
-    std::cout << "  " << programa << " imagen.ppm" << std::endl;
+    std::cout << "  " << programa << " imagen.ppm --threads 8 --modo colapsado --schedule guided" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Modos:" << std::endl;
+    std::cout << "  colapsado - collapse(2) sobre filtros y filas, usa todos los hilos (por defecto)" << std::endl;
+    std::cout << "  filas     - cada filtro reparte sus filas entre todos los hilos" << std::endl;
+    std::cout << "  filtros   - un hilo por filtro (3 hilos)" << std::endl;
+    std::cout << "Schedule: static (por defecto), guided o dynamic" << std::endl;
+    std::cout << "Hilos: --threads <n> u OMP_NUM_THREADS; por defecto todos los núcleos" << std::endl;
     std::cout << std::endl;
     std::cout << "Nota: Se generarán 3 archivos de salida con los filtros aplicados:" << std::endl;
     std::cout << "  - imagen_blur.ext" << std::endl;
@@ -34,6 +70,76 @@ std::string construirNombreSalida(const char* entrada, const char* filtro) {
     }
 }
 
+// Aplicar los 3 filtros de convolución según el modo elegido. Cada resultado se encola
+// en el escritor asíncrono en cuanto está listo, así su guardado se solapa con el resto.
+// El escritor pasa a ser dueño de las imágenes encoladas.
+template<typename ImagenT>
+void aplicarFiltrosOMP(const ImagenT& imagen_original, const FilterType* tipos_filtros,
+                       const char* const* nombres_filtros, const std::string* nombres_salida,
+                       ImagenT** resultados, int canales, ModoOMP modo, AsyncWriter& escritor) {
+    if (modo == MODO_FILTROS) {
+        #pragma omp parallel for num_threads(3)
+        for (int i = 0; i < 3; i++) {
+            int thread_id = omp_get_thread_num();
+            std::cout << "Hilo " << thread_id << " aplicando filtro " << nombres_filtros[i] << std::endl;
+            
+            resultados[i] = Filter::aplicarFiltro(&imagen_original, tipos_filtros[i]);
+            
+            if (resultados[i] != nullptr) {
+                std::cout << "Hilo " << thread_id << " completó filtro " << nombres_filtros[i] << std::endl;
+                escritor.encolar(resultados[i], nombres_salida[i]);
+            } else {
+                std::cerr << "Error en hilo " << thread_id << " aplicando filtro " << nombres_filtros[i] << std::endl;
+            }
+        }
+        return;
+    }
+    
+    if (modo == MODO_FILAS) {
+        for (int i = 0; i < 3; i++) {
+            resultados[i] = Filter::aplicarFiltro(&imagen_original, tipos_filtros[i]);
+            if (resultados[i] == nullptr) {
+                std::cerr << "Error aplicando filtro " << nombres_filtros[i] << std::endl;
+            } else {
+                escritor.encolar(resultados[i], nombres_salida[i]);
+            }
+        }
+        return;
+    }
+    
+    // Modo colapsado: un único espacio de iteraciones 3 x alto
+    for (int i = 0; i < 3; i++) {
+        resultados[i] = imagen_original.crearImagenVacia();
+        if (resultados[i] == nullptr) {
+            std::cerr << "Error reservando la salida del filtro " << nombres_filtros[i] << std::endl;
+            for (int j = 0; j < i; j++) {
+                delete resultados[j];
+                resultados[j] = nullptr;
+            }
+            return;
+        }
+    }
+    
+    const int* pixels = imagen_original.getPixels();
+    int width = imagen_original.getWidth();
+    int height = imagen_original.getHeight();
+    int max_color = imagen_original.getMaxColor();
+    int stride = width * canales;
+    int* salidas[3] = {resultados[0]->getPixels(), resultados[1]->getPixels(), resultados[2]->getPixels()};
+    
+    #pragma omp parallel for collapse(2) schedule(runtime)
+    for (int i = 0; i < 3; i++) {
+        for (int y = 0; y < height; y++) {
+            Filter::filtrarRegion(pixels, width, height, canales, max_color, tipos_filtros[i],
+                                  0, y, width, y + 1, salidas[i] + y * stride, stride);
+        }
+    }
+    
+    for (int i = 0; i < 3; i++) {
+        escritor.encolar(resultados[i], nombres_salida[i]);
+    }
+}
+
 bool esFormatoPPM(const char* filename) {
     FILE* file = fopen(filename, "r");
     if (file == nullptr) {
@@ -73,15 +179,34 @@ int main(int argc, char* argv[]) {
     
     const char* archivo_entrada = argv[1];
     
-    // Configurar OpenMP para usar 3 hilos
-    omp_set_num_threads(3);
+    // Opciones: número de hilos, modo de reparto y schedule de las filas
+    ModoOMP modo = MODO_COLAPSADO;
+    omp_sched_t schedule = omp_sched_static;
+    for (int i = 2; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0) {
+            int n = atoi(argv[i + 1]);
+            if (n > 0) {
+                omp_set_num_threads(n);
+            }
+        } else if (strcmp(argv[i], "--modo") == 0) {
+            modo = stringToModo(argv[i + 1]);
+        } else if (strcmp(argv[i], "--schedule") == 0) {
+            if (strcmp(argv[i + 1], "guided") == 0) {
+                schedule = omp_sched_guided;
+            } else if (strcmp(argv[i + 1], "dynamic") == 0) {
+                schedule = omp_sched_dynamic;
+            }
+        }
+    }
+    omp_set_schedule(schedule, 0);
     
     Timer timer_total;
     Timer timer_carga;
     
     std::cout << "=== Filtrador de Imágenes con OpenMP ===" << std::endl;
     std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
-    std::cout << "Número de hilos configurados: " << omp_get_max_threads() << std::endl;
+    std::cout << "Número de hilos configurados: " << (modo == MODO_FILTROS ? 3 : omp_get_max_threads()) << std::endl;
+    std::cout << "Modo: " << modoToString(modo) << std::endl;
     
     timer_total.start();
     
@@ -116,50 +241,35 @@ int main(int argc, char* argv[]) {
             nombres_salida[i] = construirNombreSalida(archivo_entrada, nombres_filtros[i]);
         }
         
-        // Aplicar filtros en paralelo
+        // Aplicar filtros en paralelo; los resultados se guardan en segundo plano
+        AsyncWriter escritor(3);
         std::cout << "Aplicando filtros en paralelo..." << std::endl;
         Timer timer_filtros;
         timer_filtros.start();
         
-        #pragma omp parallel for
-        for (int i = 0; i < 3; i++) {
-            int thread_id = omp_get_thread_num();
-            std::cout << "Hilo " << thread_id << " aplicando filtro " << nombres_filtros[i] << std::endl;
-            
-            resultados[i] = Filter::aplicarFiltro(&imagen_original, tipos_filtros[i]);
-            
-            if (resultados[i] != nullptr) {
-                std::cout << "Hilo " << thread_id << " completó filtro " << nombres_filtros[i] << std::endl;
-            } else {
-                std::cerr << "Error en hilo " << thread_id << " aplicando filtro " << nombres_filtros[i] << std::endl;
-            }
-        }
+        aplicarFiltrosOMP(imagen_original, tipos_filtros, nombres_filtros, nombres_salida, resultados, 3, modo, escritor);
         
         timer_filtros.stop();
         timer_filtros.printElapsed("Tiempo de aplicación de filtros");
         
-        // Guardar imágenes resultantes
-        std::cout << "Guardando imágenes filtradas..." << std::endl;
+        // Las imágenes ya se están guardando en segundo plano: solo queda esperar a las pendientes
+        std::cout << "Esperando a las escrituras pendientes..." << std::endl;
         Timer timer_guardado;
         timer_guardado.start();
         
-        bool todas_guardadas = true;
+        bool todas_guardadas = escritor.esperar();
+        std::vector<std::string> errores = escritor.getErrores();
         for (int i = 0; i < 3; i++) {
-            if (resultados[i] != nullptr) {
-                if (resultados[i]->guardarImagen(nombres_salida[i].c_str())) {
-                    std::cout << "Guardada: " << nombres_salida[i] << std::endl;
-                } else {
-                    std::cerr << "Error guardando: " << nombres_salida[i] << std::endl;
-                    todas_guardadas = false;
-                }
-                delete resultados[i];
-            } else {
+            if (resultados[i] == nullptr) {
                 todas_guardadas = false;
+            } else if (std::find(errores.begin(), errores.end(), nombres_salida[i]) == errores.end()) {
+                std::cout << "Guardada: " << nombres_salida[i] << std::endl;
             }
         }
         
         timer_guardado.stop();
-        timer_guardado.printElapsed("Tiempo de guardado");
+        timer_guardado.printElapsed("Tiempo de guardado (espera en el camino crítico)");
+        std::cout << "Tiempo de escritura en segundo plano: " << escritor.getTiempoEscritura() << " ms" << std::endl;
         
         if (!todas_guardadas) {
             std::cerr << "Error: No se pudieron guardar todas las imágenes" << std::endl;
@@ -196,50 +306,35 @@ int main(int argc, char* argv[]) {
             nombres_salida[i] = construirNombreSalida(archivo_entrada, nombres_filtros[i]);
         }
         
-        // Aplicar filtros en paralelo
+        // Aplicar filtros en paralelo; los resultados se guardan en segundo plano
+        AsyncWriter escritor(3);
         std::cout << "Aplicando filtros en paralelo..." << std::endl;
         Timer timer_filtros;
         timer_filtros.start();
         
-        #pragma omp parallel for
-        for (int i = 0; i < 3; i++) {
-            int thread_id = omp_get_thread_num();
-            std::cout << "Hilo " << thread_id << " aplicando filtro " << nombres_filtros[i] << std::endl;
-            
-            resultados[i] = Filter::aplicarFiltro(&imagen_original, tipos_filtros[i]);
-            
-            if (resultados[i] != nullptr) {
-                std::cout << "Hilo " << thread_id << " completó filtro " << nombres_filtros[i] << std::endl;
-            } else {
-                std::cerr << "Error en hilo " << thread_id << " aplicando filtro " << nombres_filtros[i] << std::endl;
-            }
-        }
+        aplicarFiltrosOMP(imagen_original, tipos_filtros, nombres_filtros, nombres_salida, resultados, 1, modo, escritor);
         
         timer_filtros.stop();
         timer_filtros.printElapsed("Tiempo de aplicación de filtros");
         
-        // Guardar imágenes resultantes
-        std::cout << "Guardando imágenes filtradas..." << std::endl;
+        // Las imágenes ya se están guardando en segundo plano: solo queda esperar a las pendientes
+        std::cout << "Esperando a las escrituras pendientes..." << std::endl;
         Timer timer_guardado;
         timer_guardado.start();
         
-        bool todas_guardadas = true;
+        bool todas_guardadas = escritor.esperar();
+        std::vector<std::string> errores = escritor.getErrores();
         for (int i = 0; i < 3; i++) {
-            if (resultados[i] != nullptr) {
-                if (resultados[i]->guardarImagen(nombres_salida[i].c_str())) {
-                    std::cout << "Guardada: " << nombres_salida[i] << std::endl;
-                } else {
-                    std::cerr << "Error guardando: " << nombres_salida[i] << std::endl;
-                    todas_guardadas = false;
-                }
-                delete resultados[i];
-            } else {
+            if (resultados[i] == nullptr) {
                 todas_guardadas = false;
+            } else if (std::find(errores.begin(), errores.end(), nombres_salida[i]) == errores.end()) {
+                std::cout << "Guardada: " << nombres_salida[i] << std::endl;
             }
         }
         
         timer_guardado.stop();
-        timer_guardado.printElapsed("Tiempo de guardado");
+        timer_guardado.printElapsed("Tiempo de guardado (espera en el camino crítico)");
+        std::cout << "Tiempo de escritura en segundo plano: " << escritor.getTiempoEscritura() << " ms" << std::endl;
         
         if (!todas_guardadas) {
             std::cerr << "Error: No se pudieron guardar todas las imágenes" << std::endl;
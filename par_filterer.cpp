@@ -0,0 +1,203 @@
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+#include <algorithm>
+#include "PGMimage.h"
+#include "PPMimage.h"
+#include "filter.h"
+#include "timer.h"
+
+// Algoritmos paralelos de C++17. En libstdc++ las políticas de ejecución usan TBB
+// como backend (enlazar con -ltbb); sin soporte se recurre al bucle secuencial.
+#if __has_include(<execution>)
+#include <execution>
+#endif
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201603L
+#define PAR_EXECUTION 1
+#endif
+
+// Filtrar la imagen con std::for_each(par_unseq) sobre los índices de fila,
+// usando el kernel compartido de filter.cpp
+template<typename ImagenT>
+ImagenT* filtrarParalelo(const ImagenT& imagen_original, FilterType filtro, int canales) {
+    // Los filtros no locales (LUT, guiado) usan el motor completo
+    if (!Filter::esConvolucion(filtro)) {
+        return Filter::aplicarFiltro(&imagen_original, filtro);
+    }
+    
+    ImagenT* imagen_salida = imagen_original.crearImagenVacia();
+    if (imagen_salida == nullptr) {
+        return nullptr;
+    }
+    
+    const int* pixels = imagen_original.getPixels();
+    int* salida = imagen_salida->getPixels();
+    int width = imagen_original.getWidth();
+    int height = imagen_original.getHeight();
+    int max_color = imagen_original.getMaxColor();
+    int stride = width * canales;
+    
+    std::vector<int> filas(height);
+    std::iota(filas.begin(), filas.end(), 0);
+    
+    auto filtrarFila = [=](int y) {
+        Filter::filtrarRegion(pixels, width, height, canales, max_color, filtro,
+                              0, y, width, y + 1, salida + y * stride, stride);
+    };
+    
+#ifdef PAR_EXECUTION
+    std::for_each(std::execution::par_unseq, filas.begin(), filas.end(), filtrarFila);
+#else
+    std::for_each(filas.begin(), filas.end(), filtrarFila);
+#endif
+    
+    return imagen_salida;
+}
+
+// Cargar, filtrar y guardar una imagen midiendo cada fase
+template<typename ImagenT>
+bool procesarImagen(const char* archivo_entrada, const char* archivo_salida, FilterType filtro,
+                    int canales, Timer& timer_carga, Timer& timer_filtro, Timer& timer_guardado) {
+    ImagenT imagen_original;
+    timer_carga.start();
+    
+    if (!imagen_original.cargarImagen(archivo_entrada)) {
+        std::cerr << "Error: No se pudo cargar la imagen" << std::endl;
+        return false;
+    }
+    
+    timer_carga.stop();
+    
+    std::cout << "Dimensiones: " << imagen_original.getWidth() << "x" << imagen_original.getHeight() << std::endl;
+    timer_carga.printElapsed("Tiempo de carga");
+    
+    std::cout << "Iniciando procesamiento paralelo..." << std::endl;
+    timer_filtro.start();
+    
+    ImagenT* imagen_salida = filtrarParalelo(imagen_original, filtro, canales);
+    
+    timer_filtro.stop();
+    
+    if (imagen_salida == nullptr) {
+        std::cerr << "Error: No se pudo aplicar el filtro" << std::endl;
+        return false;
+    }
+    
+    timer_filtro.printElapsed("Tiempo de filtrado paralelo");
+    
+    // Guardar imagen
+    timer_guardado.start();
+    if (!imagen_salida->guardarImagen(archivo_salida)) {
+        std::cerr << "Error guardando imagen" << std::endl;
+        delete imagen_salida;
+        return false;
+    }
+    timer_guardado.stop();
+    
+    delete imagen_salida;
+    return true;
+}
+
+void mostrarUso(const char* programa) {
+    std::cout << "Uso: " << programa << " <entrada> <salida> --f <filtro>" << std::endl;
+    std::cout << "Ejemplo:" << std::endl;
+    std::cout << "  " << programa << " fruit.pgm fruit_blur.pgm --f blur" << std::endl;
+    std::cout << "  " << programa << " damma.ppm damma_sharp.ppm --f sharpening" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Este programa filtra las filas con std::for_each(std::execution::par_unseq)" << std::endl;
+    std::cout << "El número de hilos lo decide el backend de la biblioteca estándar (TBB)" << std::endl;
+}
+
+bool esFormatoPPM(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (file == nullptr) return false;
+    
+    char magic[3];
+    if (fscanf(file, "%2s", magic) != 1) {
+        fclose(file);
+        return false;
+    }
+    
+    fclose(file);
+    return (strcmp(magic, "P3") == 0);
+}
+
+bool esFormatoPGM(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (file == nullptr) return false;
+    
+    char magic[3];
+    if (fscanf(file, "%2s", magic) != 1) {
+        fclose(file);
+        return false;
+    }
+    
+    fclose(file);
+    return (strcmp(magic, "P2") == 0);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cout << "Error: Argumentos insuficientes" << std::endl;
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    
+    const char* archivo_entrada = argv[1];
+    const char* archivo_salida = argv[2];
+    const char* flag_filtro = argv[3];
+    const char* nombre_filtro = argv[4];
+    
+    if (strcmp(flag_filtro, "--f") != 0) {
+        std::cout << "Error: Flag de filtro incorrecto. Use --f" << std::endl;
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    
+    FilterType filtro = Filter::stringToFilterType(nombre_filtro);
+    
+    Timer timer_total, timer_carga, timer_filtro, timer_guardado;
+    
+#ifdef PAR_EXECUTION
+    std::cout << "=== Filterer con algoritmos paralelos C++17 (par_unseq) ===" << std::endl;
+#else
+    std::cout << "=== Filterer con algoritmos paralelos C++17 (sin soporte, secuencial) ===" << std::endl;
+#endif
+    std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
+    std::cout << "Archivo de salida: " << archivo_salida << std::endl;
+    std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+    std::cout << std::endl;
+    
+    timer_total.start();
+    
+    bool correcto;
+    if (esFormatoPPM(archivo_entrada)) {
+        std::cout << "Formato detectado: PPM (P3)" << std::endl;
+        correcto = procesarImagen<PPMImage>(archivo_entrada, archivo_salida, filtro, 3,
+                                            timer_carga, timer_filtro, timer_guardado);
+    } else if (esFormatoPGM(archivo_entrada)) {
+        std::cout << "Formato detectado: PGM (P2)" << std::endl;
+        correcto = procesarImagen<PGMImage>(archivo_entrada, archivo_salida, filtro, 1,
+                                            timer_carga, timer_filtro, timer_guardado);
+    } else {
+        std::cerr << "Error: Formato no soportado" << std::endl;
+        return 1;
+    }
+    
+    if (!correcto) {
+        return 1;
+    }
+    
+    timer_total.stop();
+    
+    std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
+    timer_carga.printElapsed("Carga");
+    timer_filtro.printElapsed("Filtrado paralelo");
+    timer_guardado.printElapsed("Guardado");
+    timer_total.printElapsed("Total");
+    
+    std::cout << "Procesamiento completado exitosamente" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "parallel.h"
+#include "threadpool.h"
+#include <algorithm>
+
+int Parallel::getNumHilos() {
+    return ThreadPool::global().getNumHilos();
+}
+
+void Parallel::setNumHilos(int n) {
+    ThreadPool::configurarGlobal(n);
+}
+
+void Parallel::enCadaHilo(const std::function<void(int, int)>& func) {
+    // Dentro de un trabajador del pool se ejecuta en serie para no anidar
+    if (ThreadPool::enHiloDelPool()) {
+        func(0, 1);
+        return;
+    }
+    ThreadPool::global().ejecutar(func);
+}
+
+void Parallel::paraRango(int n, const std::function<void(int, int)>& func) {
+    if (n <= 0) {
+        return;
+    }
+
+    enCadaHilo([&](int id, int total) {
+        int bloque = n / total;
+        int extra = n % total;
+        int inicio = id * bloque + std::min(id, extra);
+        int fin = inicio + bloque + (id < extra ? 1 : 0);
+        if (inicio < fin) {
+            func(inicio, fin);
+        }
+    });
+}
\ No newline at end of file
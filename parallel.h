@@ -0,0 +1,21 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+// Utilidades de paralelismo compartidas por las operaciones de imagen.
+// Se ejecutan sobre el pool persistente global (ThreadPool::global()).
+class Parallel {
+public:
+    // Número de hilos usados por las operaciones paralelas
+    static int getNumHilos();
+    static void setNumHilos(int n);
+
+    // Ejecutar func(id_hilo, num_hilos) una vez en cada hilo
+    static void enCadaHilo(const std::function<void(int, int)>& func);
+
+    // Dividir [0, n) en bloques contiguos y ejecutar func(inicio, fin) en paralelo
+    static void paraRango(int n, const std::function<void(int, int)>& func);
+};
+
+#endif
\ No newline at end of file
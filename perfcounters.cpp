@@ -0,0 +1,280 @@
+#include "perfcounters.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* NOMBRES_EVENTOS[PERF_NUM_EVENTOS] = {
+    "ciclos", "instrucciones", "LLC", "saltos", "dTLB"
+};
+
+PerfLectura::PerfLectura() {
+    for (int e = 0; e < PERF_NUM_EVENTOS; e++) {
+        valores[e] = 0;
+        validos[e] = false;
+    }
+}
+
+void PerfLectura::sumar(const PerfLectura& otra) {
+    for (int e = 0; e < PERF_NUM_EVENTOS; e++) {
+        if (otra.validos[e]) {
+            valores[e] += otra.valores[e];
+            validos[e] = true;
+        }
+    }
+}
+
+double PerfLectura::ipc() const {
+    if (!validos[PERF_CICLOS] || !validos[PERF_INSTRUCCIONES] || valores[PERF_CICLOS] == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(valores[PERF_INSTRUCCIONES]) / valores[PERF_CICLOS];
+}
+
+#ifdef __linux__
+
+static long hiloActual() {
+    return syscall(SYS_gettid);
+}
+
+// Configuración perf_event_attr de cada evento
+static void configurarEvento(PerfEvento evento, perf_event_attr& attr) {
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (evento) {
+        case PERF_CICLOS:        attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PERF_INSTRUCCIONES: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PERF_FALLOS_LLC:    attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case PERF_FALLOS_SALTO:  attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case PERF_FALLOS_DTLB:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default: break;
+    }
+    // Solo modo usuario: basta con perf_event_paranoid <= 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+
+static int abrirEvento(PerfEvento evento, int lider) {
+    perf_event_attr attr;
+    configurarEvento(evento, attr);
+    attr.disabled = (lider == -1) ? 1 : 0;   // El grupo se habilita a través del líder
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, lider, 0));
+}
+
+// Comprobar una sola vez si el kernel deja abrir el contador de ciclos
+struct SondeoPerf {
+    bool disponible;
+    std::string motivo;
+
+    SondeoPerf() : disponible(false) {
+        int fd = abrirEvento(PERF_CICLOS, -1);
+        if (fd >= 0) {
+            close(fd);
+            disponible = true;
+            return;
+        }
+        int error = errno;
+        if (error == EACCES || error == EPERM) {
+            motivo = "acceso denegado";
+            FILE* file = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+            int nivel;
+            if (file != nullptr) {
+                if (fscanf(file, "%d", &nivel) == 1) {
+                    motivo += " (perf_event_paranoid=" + std::to_string(nivel) + ")";
+                }
+                fclose(file);
+            }
+        } else if (error == ENOENT || error == EOPNOTSUPP || error == ENODEV) {
+            motivo = "la CPU no expone contadores (máquina virtual o contenedor sin PMU)";
+        } else if (error == ENOSYS) {
+            motivo = "perf_event_open no soportado por el kernel";
+        } else {
+            motivo = strerror(error);
+        }
+    }
+};
+
+static const SondeoPerf& sondeo() {
+    static SondeoPerf resultado;
+    return resultado;
+}
+
+#endif
+
+PerfCounters::PerfCounters() : num_abiertos(0), hilo(-1) {
+    for (int e = 0; e < PERF_NUM_EVENTOS; e++) {
+        fds[e] = -1;
+        posiciones[e] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    cerrar();
+}
+
+bool PerfCounters::disponible() {
+#ifdef __linux__
+    return sondeo().disponible;
+#else
+    return false;
+#endif
+}
+
+const char* PerfCounters::motivoNoDisponible() {
+#ifdef __linux__
+    return sondeo().motivo.c_str();
+#else
+    return "perf_event_open solo existe en Linux";
+#endif
+}
+
+bool PerfCounters::abrir() {
+#ifdef __linux__
+    fds[PERF_CICLOS] = abrirEvento(PERF_CICLOS, -1);
+    if (fds[PERF_CICLOS] < 0) {
+        return false;
+    }
+    posiciones[PERF_CICLOS] = 0;
+    num_abiertos = 1;
+
+    // Los eventos que esta CPU no tenga (p. ej. dTLB en algunas VMs) se omiten
+    for (int e = PERF_CICLOS + 1; e < PERF_NUM_EVENTOS; e++) {
+        fds[e] = abrirEvento(static_cast<PerfEvento>(e), fds[PERF_CICLOS]);
+        if (fds[e] >= 0) {
+            posiciones[e] = num_abiertos++;
+        }
+    }
+    hilo = hiloActual();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PerfCounters::cerrar() {
+#ifdef __linux__
+    // Cerrar primero los miembros y después el líder
+    for (int e = PERF_NUM_EVENTOS - 1; e >= 0; e--) {
+        if (fds[e] >= 0) {
+            close(fds[e]);
+        }
+        fds[e] = -1;
+        posiciones[e] = -1;
+    }
+#endif
+    num_abiertos = 0;
+    hilo = -1;
+}
+
+void PerfCounters::start() {
+    lectura = PerfLectura();
+#ifdef __linux__
+    if (!disponible()) {
+        return;
+    }
+    // El grupo cuenta el hilo que lo abrió: si cambia el hilo, se reabre
+    if (hilo != hiloActual()) {
+        cerrar();
+        if (!abrir()) {
+            return;
+        }
+    }
+    ioctl(fds[PERF_CICLOS], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[PERF_CICLOS], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    if (num_abiertos == 0) {
+        return;
+    }
+    ioctl(fds[PERF_CICLOS], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // Formato de lectura del grupo: nr, tiempo habilitado, tiempo contando, valores[nr]
+    uint64_t buffer[3 + PERF_NUM_EVENTOS];
+    ssize_t leidos = read(fds[PERF_CICLOS], buffer, sizeof(buffer));
+    if (leidos < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[2] == 0) {
+        return;   // El grupo no llegó a contar (PMU ocupada)
+    }
+
+    // Escalar si el kernel multiplexó el grupo con otros
+    double escala = static_cast<double>(buffer[1]) / buffer[2];
+    for (int e = 0; e < PERF_NUM_EVENTOS; e++) {
+        if (posiciones[e] >= 0 && posiciones[e] < static_cast<int>(buffer[0])) {
+            lectura.valores[e] = static_cast<uint64_t>(buffer[3 + posiciones[e]] * escala);
+            lectura.validos[e] = true;
+        }
+    }
+#endif
+}
+
+void PerfCounters::iniciarEnPool(ThreadPool& pool, std::vector<PerfCounters>& contadores) {
+    if (!disponible()) {
+        return;
+    }
+    pool.ejecutar([&](int id, int) {
+        if (id < static_cast<int>(contadores.size())) {
+            contadores[id].start();
+        }
+    });
+}
+
+PerfLectura PerfCounters::detenerEnPool(ThreadPool& pool, std::vector<PerfCounters>& contadores) {
+    PerfLectura total;
+    if (!disponible()) {
+        return total;
+    }
+    pool.ejecutar([&](int id, int) {
+        if (id < static_cast<int>(contadores.size())) {
+            contadores[id].stop();
+        }
+    });
+    for (size_t i = 0; i < contadores.size(); i++) {
+        total.sumar(contadores[i].getLectura());
+    }
+    return total;
+}
+
+void PerfCounters::imprimir(const PerfLectura& lectura, long long pixeles) {
+    if (!lectura.hayDatos()) {
+        return;
+    }
+
+    std::cout << "    ciclos " << lectura.valores[PERF_CICLOS] / 1e6 << "M";
+    if (lectura.validos[PERF_INSTRUCCIONES]) {
+        std::cout << ", instrucciones " << lectura.valores[PERF_INSTRUCCIONES] / 1e6
+                  << "M, IPC " << lectura.ipc();
+    }
+
+    // Fallos por píxel (un píxel cuenta una vez aunque tenga varios canales)
+    if (pixeles > 0) {
+        std::cout << " | por píxel:";
+        const char* separador = " ";
+        for (int e = PERF_FALLOS_LLC; e < PERF_NUM_EVENTOS; e++) {
+            std::cout << separador << NOMBRES_EVENTOS[e] << " ";
+            if (lectura.validos[e]) {
+                std::cout << static_cast<double>(lectura.valores[e]) / pixeles;
+            } else {
+                std::cout << "n/d";
+            }
+            separador = ", ";
+        }
+    }
+    std::cout << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint>
+#include <vector>
+#include "threadpool.h"
+
+// Eventos hardware medidos en cada grupo
+enum PerfEvento {
+    PERF_CICLOS,
+    PERF_INSTRUCCIONES,
+    PERF_FALLOS_LLC,
+    PERF_FALLOS_SALTO,
+    PERF_FALLOS_DTLB,
+    PERF_NUM_EVENTOS
+};
+
+// Valores leídos de un grupo (escalados si el kernel multiplexó los contadores)
+struct PerfLectura {
+    uint64_t valores[PERF_NUM_EVENTOS];
+    bool validos[PERF_NUM_EVENTOS];
+
+    PerfLectura();
+
+    // Acumular otra lectura (p. ej. la de otro hilo de la misma fase)
+    void sumar(const PerfLectura& otra);
+
+    bool hayDatos() const { return validos[PERF_CICLOS]; }
+
+    // Instrucciones por ciclo; 0 si falta alguno de los dos contadores
+    double ipc() const;
+};
+
+// Contadores hardware de un hilo mediante un grupo perf_event_open (solo modo usuario).
+// El grupo cuenta únicamente el hilo que llama a start(): para medir una fase paralela
+// cada hilo debe tener sus propios contadores (ver iniciarEnPool/detenerEnPool).
+// Si el kernel deniega el acceso (perf_event_paranoid, contenedor sin PMU) start/stop no
+// hacen nada y los drivers se quedan solo con el tiempo de pared de Timer.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    // Poner los contadores a cero y empezar a contar en el hilo actual
+    void start();
+
+    // Dejar de contar y guardar la lectura
+    void stop();
+
+    const PerfLectura& getLectura() const { return lectura; }
+
+    // true si el kernel permite abrir contadores hardware (se comprueba una vez)
+    static bool disponible();
+
+    // Motivo por el que no hay contadores (vacío si están disponibles)
+    static const char* motivoNoDisponible();
+
+    // Iniciar/detener contadores[id] en cada hilo del pool (el llamador es el hilo 0).
+    // detenerEnPool devuelve la suma de todos los hilos.
+    static void iniciarEnPool(ThreadPool& pool, std::vector<PerfCounters>& contadores);
+    static PerfLectura detenerEnPool(ThreadPool& pool, std::vector<PerfCounters>& contadores);
+
+    // Imprimir "  ciclos ..., IPC ..., por píxel: LLC ..., saltos ..., dTLB ..." para una fase
+    static void imprimir(const PerfLectura& lectura, long long pixeles);
+
+private:
+    // Abrir el grupo en el hilo actual; false si el kernel no lo permite
+    bool abrir();
+    void cerrar();
+
+    int fds[PERF_NUM_EVENTOS];        // -1 si el evento no se pudo abrir
+    int posiciones[PERF_NUM_EVENTOS]; // Posición del evento en la lectura del grupo
+    int num_abiertos;
+    long hilo;                        // Hilo en el que se abrió el grupo
+    PerfLectura lectura;
+
+    // No copiable
+    PerfCounters(const PerfCounters&);
+    PerfCounters& operator=(const PerfCounters&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef PNMTEXT_H
+#define PNMTEXT_H
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+// Lector con buffer propio para PGM (P2) y PPM (P3): enteros ASCII separados por espacios
+// y comentarios con '#'. Permite parsear el archivo fila a fila sin cargarlo entero.
+class LectorPNM {
+public:
+    // Tamaño de los bloques de lectura
+    static const size_t TAM_BLOQUE = 1 << 16;
+
+    explicit LectorPNM(FILE* f) : file(f), buffer(TAM_BLOQUE), pos(0), fin(0) {}
+
+    int siguienteCaracter() {
+        if (pos == fin) {
+            fin = fread(buffer.data(), 1, buffer.size(), file);
+            pos = 0;
+            if (fin == 0) {
+                return EOF;
+            }
+        }
+        return static_cast<unsigned char>(buffer[pos++]);
+    }
+
+    // Saltar espacios y comentarios; devuelve el primer carácter significativo
+    int saltarEspacios() {
+        int c = siguienteCaracter();
+        while (c != EOF) {
+            if (c == '#') {
+                while ((c = siguienteCaracter()) != EOF && c != '\n');
+            } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                return c;
+            } else {
+                c = siguienteCaracter();
+            }
+        }
+        return EOF;
+    }
+
+    bool leerEntero(int& valor) {
+        int c = saltarEspacios();
+        bool negativo = false;
+        if (c == '-') {
+            negativo = true;
+            c = siguienteCaracter();
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        valor = 0;
+        while (c >= '0' && c <= '9') {
+            valor = valor * 10 + (c - '0');
+            c = siguienteCaracter();
+        }
+        if (negativo) {
+            valor = -valor;
+        }
+        return true;
+    }
+
+    bool leerMagico(char magic[3]) {
+        int c0 = saltarEspacios();
+        int c1 = siguienteCaracter();
+        if (c0 == EOF || c1 == EOF) {
+            return false;
+        }
+        magic[0] = static_cast<char>(c0);
+        magic[1] = static_cast<char>(c1);
+        magic[2] = '\0';
+        return true;
+    }
+
+private:
+    FILE* file;
+    std::vector<char> buffer;
+    size_t pos, fin;
+};
+
+// Escritura de muestras en texto, una por línea como fprintf("%d\n")
+class EscritorPNM {
+public:
+    // Escribir "valor\n" en destino y devolver la posición siguiente
+    static char* escribirEntero(char* destino, int valor) {
+        if (valor < 0) {
+            *destino++ = '-';
+            valor = -valor;
+        }
+        char digitos[12];
+        int n = 0;
+        do {
+            digitos[n++] = static_cast<char>('0' + valor % 10);
+            valor /= 10;
+        } while (valor > 0);
+        while (n > 0) {
+            *destino++ = digitos[--n];
+        }
+        *destino++ = '\n';
+        return destino;
+    }
+
+    // Formatear n muestras en texto (en un buffer reutilizable) y escribirlas en output
+    static bool escribirMuestras(FILE* output, const int* muestras, size_t n, std::vector<char>& texto) {
+        // Hasta 11 caracteres por muestra ("-2147483648\n" no aparece con max_color válido)
+        if (texto.size() < n * 12) {
+            texto.resize(n * 12);
+        }
+        char* p = texto.data();
+        for (size_t i = 0; i < n; i++) {
+            p = escribirEntero(p, muestras[i]);
+        }
+        size_t bytes = p - texto.data();
+        return fwrite(texto.data(), 1, bytes, output) == bytes;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -1,21 +1,17 @@
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
-#include <pthread.h>
+#include <vector>
 #include "PGMimage.h"
 #include "PPMimage.h"
 #include "filter.h"
+#include "numa.h"
+#include "perfcounters.h"
+#include "scheduler.h"
+#include "threadpool.h"
 #include "timer.h"
 
-#define NUM_THREADS 4
-
-enum RegionType {
-    TOP_LEFT = 0,
-    TOP_RIGHT = 1,
-    BOTTOM_LEFT = 2,
-    BOTTOM_RIGHT = 3
-};
-
 struct ThreadData {
     const int* pixels_entrada;
     int* pixels_salida;
@@ -25,160 +21,140 @@ struct ThreadData {
     int start_x, start_y;
     int end_x, end_y;
     FilterType filtro;
-    bool es_color; // true para PPM, false para PGM
-    RegionType region;
+    int canales; // 3 para PPM, 1 para PGM
     int thread_id;
-    Timer* timer;
-};
-
-class FilterPthread {
-public:
-    static const float blur_kernel[3][3];
-    static const float laplace_kernel[3][3];
-    static const float sharpening_kernel[3][3];
-    
-    static const float (*getKernel(FilterType tipo))[3];
-    static int aplicarConvolucion(const int* pixels, int width, int height, 
-                                 int x, int y, const float kernel[3][3], int max_color);
-    static int aplicarConvolucionColor(const int* pixels, int width, int height,
-                                      int x, int y, int canal, const float kernel[3][3], int max_color);
-};
-
-const float FilterPthread::blur_kernel[3][3] = {
-    {1.0f/9, 1.0f/9, 1.0f/9},
-    {1.0f/9, 1.0f/9, 1.0f/9},
-    {1.0f/9, 1.0f/9, 1.0f/9}
 };
 
-const float FilterPthread::laplace_kernel[3][3] = {
-    { 0.0f, -1.0f,  0.0f},
-    {-1.0f,  4.0f, -1.0f},
-    { 0.0f, -1.0f,  0.0f}
-};
+void procesarRegion(ThreadData* data) {
+    // Kernel compartido de filter.cpp, escribiendo directamente en la región de salida
+    int stride = data->width * data->canales;
+    int* destino = data->pixels_salida + data->start_y * stride + data->start_x * data->canales;
+    Filter::filtrarRegion(data->pixels_entrada, data->width, data->height, data->canales,
+                          data->max_color, data->filtro, data->start_x, data->start_y,
+                          data->end_x, data->end_y, destino, stride);
+}
 
-const float FilterPthread::sharpening_kernel[3][3] = {
-    { 0.0f, -1.0f,  0.0f},
-    {-1.0f,  5.0f, -1.0f},
-    { 0.0f, -1.0f,  0.0f}
+// Tráfico de memoria por thread: bytes leídos de la entrada y cuántos estaban en otro nodo NUMA
+struct TraficoNuma {
+    std::vector<long long> leidos;
+    std::vector<long long> remotos;
+    std::vector<std::vector<int> > filas_leidas;   // Pares [inicio, fin) de filas leídas por el thread
 };
 
-const float (*FilterPthread::getKernel(FilterType tipo))[3] {
-    switch (tipo) {
-        case BLUR: return blur_kernel;
-        case LAPLACE: return laplace_kernel;
-        case SHARPENING: return sharpening_kernel;
-        default: return blur_kernel;
+// Recolocar el buffer de la imagen con primer contacto en paralelo: cada banda queda
+// en el nodo NUMA del thread que la procesará (sin efecto con un único nodo)
+template<typename ImagenT>
+void colocarEnNodos(ImagenT& imagen, BandScheduler& planificador, int canales) {
+    if (Numa::topologia().num_nodos < 2) {
+        return;
+    }
+    int* recolocado = Numa::primerContacto(planificador, imagen.getPixels(), imagen.getHeight(),
+                                           imagen.getWidth() * canales);
+    if (recolocado != nullptr) {
+        imagen.setPixels(recolocado);
     }
 }
 
-int FilterPthread::aplicarConvolucion(const int* pixels, int width, int height, 
-                                     int x, int y, const float kernel[3][3], int max_color) {
-    float sum = 0.0f;
-    float weight_sum = 0.0f;
-    
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            int nx = x + kx;
-            int ny = y + ky;
-            
-            if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                int idx = ny * width + nx;
-                float kernel_val = kernel[ky + 1][kx + 1];
-                sum += pixels[idx] * kernel_val;
-                weight_sum += (kernel_val > 0) ? kernel_val : 0;
-            }
-        }
-    }
-    
-    int result;
-    if (weight_sum > 0) {
-        result = static_cast<int>(sum / weight_sum);
-    } else {
-        result = static_cast<int>(sum);
+// Filtrar la imagen con el pool persistente: bandas de filas de ancho completo repartidas
+// por el planificador con robo de trabajo (los hilos que acaban antes roban bandas)
+template<typename ImagenT>
+ImagenT* filtrarParalelo(const ImagenT& imagen_original, FilterType filtro, int canales,
+                         BandScheduler& planificador, std::vector<Timer>& timers_threads,
+                         std::vector<PerfCounters>& contadores_threads,
+                         bool primer_contacto, TraficoNuma& trafico) {
+    // Los filtros no locales (LUT, guiado) usan el motor completo sobre el mismo pool
+    if (!Filter::esConvolucion(filtro)) {
+        timers_threads[0].start();
+        PerfCounters::iniciarEnPool(ThreadPool::global(), contadores_threads);
+        ImagenT* resultado = Filter::aplicarFiltro(&imagen_original, filtro);
+        PerfCounters::detenerEnPool(ThreadPool::global(), contadores_threads);
+        timers_threads[0].stop();
+        return resultado;
     }
     
-    return std::max(0, std::min(max_color, result));
-}
-
-int FilterPthread::aplicarConvolucionColor(const int* pixels, int width, int height,
-                                          int x, int y, int canal, const float kernel[3][3], int max_color) {
-    float sum = 0.0f;
-    float weight_sum = 0.0f;
+    int width = imagen_original.getWidth();
+    int height = imagen_original.getHeight();
+    int stride = width * canales;
+    bool varios_nodos = Numa::topologia().num_nodos > 1;
     
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            int nx = x + kx;
-            int ny = y + ky;
-            
-            if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                int idx = (ny * width + nx) * 3 + canal;
-                float kernel_val = kernel[ky + 1][kx + 1];
-                sum += pixels[idx] * kernel_val;
-                weight_sum += (kernel_val > 0) ? kernel_val : 0;
-            }
+    // El buffer de salida se coloca antes de crear la imagen y sin ponerlo a cero en este hilo:
+    // el filtrado escribe todos sus píxeles, bordes incluidos. Con varios nodos, cada banda se
+    // toca primero desde el thread que la procesará
+    int* pixels_salida = nullptr;
+    if (primer_contacto && varios_nodos) {
+        pixels_salida = Numa::primerContacto(planificador, nullptr, height, stride);
+    }
+    if (pixels_salida == nullptr) {
+        pixels_salida = (int*)malloc(static_cast<size_t>(height) * stride * sizeof(int));
+        if (pixels_salida == nullptr) {
+            return nullptr;
         }
     }
+    ImagenT* imagen_salida = imagen_original.crearImagenConPixeles(pixels_salida);
     
-    int result;
-    if (weight_sum > 0) {
-        result = static_cast<int>(sum / weight_sum);
-    } else {
-        result = static_cast<int>(sum);
+    trafico.leidos.assign(timers_threads.size(), 0);
+    trafico.remotos.assign(timers_threads.size(), 0);
+    trafico.filas_leidas.assign(timers_threads.size(), std::vector<int>());
+    if (varios_nodos) {
+        // Capacidad para todas las bandas: la región medida no reserva memoria
+        int filas_banda = std::max(1, planificador.getFilasPorBanda());
+        for (size_t i = 0; i < trafico.filas_leidas.size(); i++) {
+            trafico.filas_leidas[i].reserve(2 * ((height + filas_banda - 1) / filas_banda));
+        }
     }
     
-    return std::max(0, std::min(max_color, result));
-}
-
-void* procesarRegion(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    
-    data->timer->start();
-    
-    const float (*kernel)[3] = FilterPthread::getKernel(data->filtro);
-    
-    std::cout << "Thread " << data->thread_id << " procesando región (" 
-              << data->start_x << "," << data->start_y << ") a (" 
-              << data->end_x << "," << data->end_y << ")" << std::endl;
+    planificador.ejecutar(height, [&](int fila_ini, int fila_fin, int id) {
+        // Filas de entrada que lee la banda (incluye el halo de la convolución 3x3)
+        int lect_ini = (fila_ini > 0) ? fila_ini - 1 : 0;
+        int lect_fin = (fila_fin < height) ? fila_fin + 1 : height;
+        long long bytes = static_cast<long long>(lect_fin - lect_ini) * stride * sizeof(int);
+        trafico.leidos[id] += bytes;
+        if (varios_nodos) {
+            trafico.filas_leidas[id].push_back(lect_ini);
+            trafico.filas_leidas[id].push_back(lect_fin);
+        }
+        
+        ThreadData data = {imagen_original.getPixels(), imagen_salida->getPixels(),
+                           width, height, imagen_original.getMaxColor(),
+                           0, fila_ini, width, fila_fin, filtro, canales, id};
+        procesarRegion(&data);
+    }, &timers_threads, &contadores_threads);
     
-    if (data->es_color) {
-        // Procesar imagen PPM
-        for (int y = data->start_y; y < data->end_y; y++) {
-            for (int x = data->start_x; x < data->end_x; x++) {
-                int r = FilterPthread::aplicarConvolucionColor(data->pixels_entrada, data->width, data->height, x, y, 0, kernel, data->max_color);
-                int g = FilterPthread::aplicarConvolucionColor(data->pixels_entrada, data->width, data->height, x, y, 1, kernel, data->max_color);
-                int b = FilterPthread::aplicarConvolucionColor(data->pixels_entrada, data->width, data->height, x, y, 2, kernel, data->max_color);
-                
-                int base_idx = (y * data->width + x) * 3;
-                data->pixels_salida[base_idx] = r;
-                data->pixels_salida[base_idx + 1] = g;
-                data->pixels_salida[base_idx + 2] = b;
+    // Residencia de las páginas leídas, medida por cada thread desde su nodo fuera de la
+    // región cronometrada: move_pages recorre todas las páginas y falsearía tiempos y contadores
+    if (varios_nodos) {
+        ThreadPool::global().ejecutar([&](int id, int) {
+            if (id >= (int)trafico.filas_leidas.size()) {
+                return;
             }
-        }
-    } else {
-        // Procesar imagen PGM
-        for (int y = data->start_y; y < data->end_y; y++) {
-            for (int x = data->start_x; x < data->end_x; x++) {
-                int valor = FilterPthread::aplicarConvolucion(data->pixels_entrada, data->width, data->height, x, y, kernel, data->max_color);
-                int idx = y * data->width + x;
-                data->pixels_salida[idx] = valor;
+            const std::vector<int>& filas = trafico.filas_leidas[id];
+            int nodo = Numa::nodoActual();
+            for (size_t i = 0; i + 1 < filas.size(); i += 2) {
+                long long bytes = static_cast<long long>(filas[i + 1] - filas[i]) * stride * sizeof(int);
+                trafico.remotos[id] += Numa::bytesRemotos(imagen_original.getPixels() + filas[i] * stride,
+                                                          bytes, nodo);
             }
-        }
+        });
     }
     
-    data->timer->stop();
-    
-    std::cout << "Thread " << data->thread_id << " completado" << std::endl;
-    
-    pthread_exit(nullptr);
+    return imagen_salida;
 }
 
 void mostrarUso(const char* programa) {
-    std::cout << "Uso: " << programa << " <entrada> <salida> --f <filtro>" << std::endl;
+    std::cout << "Uso: " << programa << " <entrada> <salida> --f <filtro> [--threads <n>] [--band <filas>]" << std::endl;
+    std::cout << "       [--pin none|compact|scatter] [--no-first-touch]" << std::endl;
     std::cout << "Ejemplo:" << std::endl;
     std::cout << "  " << programa << " fruit.pgm fruit_blur2.pgm --f blur" << std::endl;
     std::cout << "  " << programa << " damma.ppm damma_sharp.ppm --f sharpening" << std::endl;
     std::cout << std::endl;
-    std::cout << "Este programa usa 4 threads para procesar 4 regiones de la imagen" << std::endl;
+    std::cout << "Este programa divide la imagen en bandas de filas de ancho completo; cada thread" << std::endl;
+    std::cout << "procesa las suyas y roba bandas pendientes de otros al terminar" << std::endl;
+    std::cout << "Tamaño de banda: --band <filas> (por defecto ~8 bandas por thread)" << std::endl;
+    std::cout << "NUMA: --pin fija cada thread a un núcleo (compact llena un nodo antes de pasar al" << std::endl;
+    std::cout << "siguiente, scatter alterna nodos). Con varios nodos los buffers se colocan por bandas" << std::endl;
+    std::cout << "con primer contacto en paralelo (desactivar con --no-first-touch)" << std::endl;
+    std::cout << "Número de threads: --threads <n>, o variable FILTER_THREADS, o cuota de CPU del" << std::endl;
+    std::cout << "contenedor (cgroup), o número de núcleos disponibles" << std::endl;
 }
 
 bool esFormatoPPM(const char* filename) {
@@ -229,15 +205,54 @@ int main(int argc, char* argv[]) {
     
     FilterType filtro = Filter::stringToFilterType(nombre_filtro);
     
+    // Tamaño del pool: --threads tiene prioridad sobre la detección automática
+    int filas_banda = 0;
+    PinPolicy politica = PIN_NONE;
+    bool primer_contacto = true;
+    for (int i = 5; i < argc; i++) {
+        if (strcmp(argv[i], "--no-first-touch") == 0) {
+            primer_contacto = false;
+        } else if (i + 1 >= argc) {
+            break;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            ThreadPool::configurarGlobal(atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "--band") == 0) {
+            filas_banda = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            politica = Numa::stringToPinPolicy(argv[i + 1]);
+        }
+    }
+    
+    // Pool persistente compartido con el motor de filtros: los hilos se crean una vez
+    ThreadPool& pool = ThreadPool::global();
+    int num_hilos = pool.getNumHilos();
+    
     Timer timer_total, timer_carga, timer_filtro, timer_guardado;
-    Timer timers_threads[NUM_THREADS];
+    std::vector<Timer> timers_threads(num_hilos);
     
-    std::cout << "=== Filterer con Pthreads (" << NUM_THREADS << " threads) ===" << std::endl;
+    // Contadores hardware por fase y por thread (sin efecto si el kernel no los permite)
+    PerfCounters perf_carga, perf_guardado;
+    std::vector<PerfCounters> perf_threads(num_hilos);
+    long long pixeles = 0;
+    
+    std::cout << "=== Filterer con Pthreads (" << num_hilos << " threads) ===" << std::endl;
     std::cout << "Archivo de entrada: " << archivo_entrada << std::endl;
     std::cout << "Archivo de salida: " << archivo_salida << std::endl;
     std::cout << "Filtro: " << Filter::filterTypeToString(filtro) << std::endl;
+    std::cout << "Nodos NUMA: " << Numa::topologia().num_nodos
+              << ", afinidad: " << Numa::pinPolicyToString(politica) << std::endl;
+    if (PerfCounters::disponible()) {
+        std::cout << "Contadores hardware: ciclos, instrucciones, fallos LLC, de salto y de dTLB" << std::endl;
+    } else {
+        std::cout << "Contadores hardware no disponibles: " << PerfCounters::motivoNoDisponible()
+                  << "; solo tiempo de pared" << std::endl;
+    }
     std::cout << std::endl;
     
+    Numa::fijarPool(pool, politica);
+    BandScheduler planificador(pool, filas_banda);
+    TraficoNuma trafico;
+    
     timer_total.start();
     
     if (esFormatoPPM(archivo_entrada)) {
@@ -245,78 +260,53 @@ int main(int argc, char* argv[]) {
         
         PPMImage imagen_original;
         timer_carga.start();
+        perf_carga.start();
         
         if (!imagen_original.cargarImagen(archivo_entrada)) {
             std::cerr << "Error: No se pudo cargar la imagen PPM" << std::endl;
             return 1;
         }
         
+        perf_carga.stop();
         timer_carga.stop();
+        pixeles = static_cast<long long>(imagen_original.getWidth()) * imagen_original.getHeight();
         
-        int width = imagen_original.getWidth();
-        int height = imagen_original.getHeight();
-        int max_color = imagen_original.getMaxColor();
-        
-        std::cout << "Dimensiones: " << width << "x" << height << std::endl;
+        std::cout << "Dimensiones: " << imagen_original.getWidth() << "x" << imagen_original.getHeight() << std::endl;
         timer_carga.printElapsed("Tiempo de carga");
         
-        // Crear imagen de salida
-        PPMImage* imagen_salida = imagen_original.crearImagenVacia();
-        
-        // Configurar threads
-        pthread_t threads[NUM_THREADS];
-        ThreadData thread_data[NUM_THREADS];
-        
-        int mid_x = width / 2;
-        int mid_y = height / 2;
-        
-        // Thread 0: Top-left
-        thread_data[0] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, 0, 0, mid_x, mid_y, 
-                          filtro, true, TOP_LEFT, 0, &timers_threads[0]};
-        
-        // Thread 1: Top-right
-        thread_data[1] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, mid_x, 0, width, mid_y, 
-                          filtro, true, TOP_RIGHT, 1, &timers_threads[1]};
-        
-        // Thread 2: Bottom-left
-        thread_data[2] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, 0, mid_y, mid_x, height, 
-                          filtro, true, BOTTOM_LEFT, 2, &timers_threads[2]};
+        if (filas_banda <= 0) {
+            planificador.setFilasPorBanda(BandScheduler::bandaPorDefecto(imagen_original.getHeight(), num_hilos));
+        }
+        std::cout << "Bandas de " << planificador.getFilasPorBanda() << " filas" << std::endl;
         
-        // Thread 3: Bottom-right
-        thread_data[3] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, mid_x, mid_y, width, height, 
-                          filtro, true, BOTTOM_RIGHT, 3, &timers_threads[3]};
+        if (primer_contacto) {
+            colocarEnNodos(imagen_original, planificador, 3);
+        }
         
         std::cout << "Iniciando procesamiento paralelo..." << std::endl;
         timer_filtro.start();
         
-        // Crear threads
-        for (int i = 0; i < NUM_THREADS; i++) {
-            if (pthread_create(&threads[i], nullptr, procesarRegion, &thread_data[i]) != 0) {
-                std::cerr << "Error creando thread " << i << std::endl;
-                delete imagen_salida;
-                return 1;
-            }
-        }
+        PPMImage* imagen_salida = filtrarParalelo(imagen_original, filtro, 3, planificador, timers_threads,
+                                                    perf_threads, primer_contacto, trafico);
         
-        // Esperar threads
-        for (int i = 0; i < NUM_THREADS; i++) {
-            pthread_join(threads[i], nullptr);
+        timer_filtro.stop();
+        
+        if (imagen_salida == nullptr) {
+            std::cerr << "Error: No se pudo aplicar el filtro" << std::endl;
+            return 1;
         }
         
-        timer_filtro.stop();
         timer_filtro.printElapsed("Tiempo de filtrado paralelo");
         
         // Guardar imagen
         timer_guardado.start();
+        perf_guardado.start();
         if (!imagen_salida->guardarImagen(archivo_salida)) {
             std::cerr << "Error guardando imagen" << std::endl;
             delete imagen_salida;
             return 1;
         }
+        perf_guardado.stop();
         timer_guardado.stop();
         
         delete imagen_salida;
@@ -326,78 +316,53 @@ int main(int argc, char* argv[]) {
         
         PGMImage imagen_original;
         timer_carga.start();
+        perf_carga.start();
         
         if (!imagen_original.cargarImagen(archivo_entrada)) {
             std::cerr << "Error: No se pudo cargar la imagen PGM" << std::endl;
             return 1;
         }
         
+        perf_carga.stop();
         timer_carga.stop();
+        pixeles = static_cast<long long>(imagen_original.getWidth()) * imagen_original.getHeight();
         
-        int width = imagen_original.getWidth();
-        int height = imagen_original.getHeight();
-        int max_color = imagen_original.getMaxColor();
-        
-        std::cout << "Dimensiones: " << width << "x" << height << std::endl;
+        std::cout << "Dimensiones: " << imagen_original.getWidth() << "x" << imagen_original.getHeight() << std::endl;
         timer_carga.printElapsed("Tiempo de carga");
         
-        // Crear imagen de salida
-        PGMImage* imagen_salida = imagen_original.crearImagenVacia();
-        
-        // Configurar threads
-        pthread_t threads[NUM_THREADS];
-        ThreadData thread_data[NUM_THREADS];
-        
-        int mid_x = width / 2;
-        int mid_y = height / 2;
-        
-        // Thread 0: Top-left
-        thread_data[0] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, 0, 0, mid_x, mid_y, 
-                          filtro, false, TOP_LEFT, 0, &timers_threads[0]};
-        
-        // Thread 1: Top-right
-        thread_data[1] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, mid_x, 0, width, mid_y, 
-                          filtro, false, TOP_RIGHT, 1, &timers_threads[1]};
-        
-        // Thread 2: Bottom-left
-        thread_data[2] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, 0, mid_y, mid_x, height, 
-                          filtro, false, BOTTOM_LEFT, 2, &timers_threads[2]};
+        if (filas_banda <= 0) {
+            planificador.setFilasPorBanda(BandScheduler::bandaPorDefecto(imagen_original.getHeight(), num_hilos));
+        }
+        std::cout << "Bandas de " << planificador.getFilasPorBanda() << " filas" << std::endl;
         
-        // Thread 3: Bottom-right
-        thread_data[3] = {imagen_original.getPixels(), imagen_salida->getPixels(), 
-                          width, height, max_color, mid_x, mid_y, width, height, 
-                          filtro, false, BOTTOM_RIGHT, 3, &timers_threads[3]};
+        if (primer_contacto) {
+            colocarEnNodos(imagen_original, planificador, 1);
+        }
         
         std::cout << "Iniciando procesamiento paralelo..." << std::endl;
         timer_filtro.start();
         
-        // Crear threads
-        for (int i = 0; i < NUM_THREADS; i++) {
-            if (pthread_create(&threads[i], nullptr, procesarRegion, &thread_data[i]) != 0) {
-                std::cerr << "Error creando thread " << i << std::endl;
-                delete imagen_salida;
-                return 1;
-            }
-        }
+        PGMImage* imagen_salida = filtrarParalelo(imagen_original, filtro, 1, planificador, timers_threads,
+                                                    perf_threads, primer_contacto, trafico);
         
-        // Esperar threads
-        for (int i = 0; i < NUM_THREADS; i++) {
-            pthread_join(threads[i], nullptr);
+        timer_filtro.stop();
+        
+        if (imagen_salida == nullptr) {
+            std::cerr << "Error: No se pudo aplicar el filtro" << std::endl;
+            return 1;
         }
         
-        timer_filtro.stop();
         timer_filtro.printElapsed("Tiempo de filtrado paralelo");
         
         // Guardar imagen
         timer_guardado.start();
+        perf_guardado.start();
         if (!imagen_salida->guardarImagen(archivo_salida)) {
             std::cerr << "Error guardando imagen" << std::endl;
             delete imagen_salida;
             return 1;
         }
+        perf_guardado.stop();
         timer_guardado.stop();
         
         delete imagen_salida;
@@ -411,12 +376,41 @@ int main(int argc, char* argv[]) {
     
     std::cout << std::endl << "=== Resumen de Tiempos ===" << std::endl;
     timer_carga.printElapsed("Carga");
+    PerfCounters::imprimir(perf_carga.getLectura(), pixeles);
     timer_filtro.printElapsed("Filtrado paralelo");
+    PerfLectura perf_filtro;
+    for (int i = 0; i < num_hilos; i++) {
+        perf_filtro.sumar(perf_threads[i].getLectura());
+    }
+    PerfCounters::imprimir(perf_filtro, pixeles);
     timer_guardado.printElapsed("Guardado");
+    PerfCounters::imprimir(perf_guardado.getLectura(), pixeles);
     
     std::cout << std::endl << "=== Tiempos por Thread ===" << std::endl;
-    for (int i = 0; i < NUM_THREADS; i++) {
-        std::cout << "Thread " << i << ": " << timers_threads[i].getElapsedMilliseconds() << " ms" << std::endl;
+    const std::vector<WorkerStats>& stats = planificador.getEstadisticas();
+    for (int i = 0; i < num_hilos; i++) {
+        std::cout << "Thread " << i << ": " << timers_threads[i].getElapsedMilliseconds() << " ms";
+        if (i < (int)stats.size()) {
+            std::cout << " (ocupado " << stats[i].ocupado_ms << " ms, inactivo " << stats[i].inactivo_ms
+                      << " ms, " << stats[i].bandas << " bandas, " << stats[i].robadas << " robadas)";
+        }
+        if (i < (int)trafico.remotos.size() && Numa::topologia().num_nodos > 1) {
+            std::cout << " [remoto " << trafico.remotos[i] / 1024 << " KB]";
+        }
+        std::cout << std::endl;
+        PerfCounters::imprimir(perf_threads[i].getLectura(), pixeles);
+    }
+    
+    // Tráfico entre nodos: bytes de entrada leídos desde páginas de otro nodo NUMA
+    long long total_leidos = 0, total_remotos = 0;
+    for (size_t i = 0; i < trafico.leidos.size(); i++) {
+        total_leidos += trafico.leidos[i];
+        total_remotos += trafico.remotos[i];
+    }
+    if (total_leidos > 0) {
+        std::cout << "Tráfico entre nodos: " << total_remotos / (1024.0 * 1024.0) << " MB remotos de "
+                  << total_leidos / (1024.0 * 1024.0) << " MB leídos ("
+                  << 100.0 * total_remotos / total_leidos << "%)" << std::endl;
     }
     
     timer_total.printElapsed("Total");
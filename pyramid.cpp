@@ -0,0 +1,199 @@
+#include "pyramid.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+// Filas de salida que toma cada hilo de una vez
+static const int FILAS_POR_TAREA = 4;
+
+template<typename ImagenT>
+static std::vector<ImagenT*> generarPiramideImagen(const ImagenT* imagen, int niveles,
+                                                    PyramidType tipo, int canales,
+                                                    void (*generar)(const int*, int, int, int, int, PyramidType,
+                                                                    int* const*, const int*, const int*)) {
+    std::vector<ImagenT*> resultado;
+    if (imagen == nullptr || imagen->getPixels() == nullptr || niveles <= 0) {
+        return resultado;
+    }
+
+    niveles = std::min(niveles, Pyramid::nivelesMaximos(imagen->getWidth(), imagen->getHeight()));
+
+    std::vector<int*> salidas(niveles);
+    std::vector<int> anchos(niveles), altos(niveles);
+    int w = imagen->getWidth();
+    int h = imagen->getHeight();
+
+    // Reservar todos los niveles por adelantado para poder escribir en pipeline
+    for (int k = 0; k < niveles; k++) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        ImagenT* nivel = imagen->crearImagenVacia(w, h);
+        if (nivel == nullptr) {
+            for (size_t i = 0; i < resultado.size(); i++) {
+                delete resultado[i];
+            }
+            resultado.clear();
+            return resultado;
+        }
+        resultado.push_back(nivel);
+        salidas[k] = nivel->getPixels();
+        anchos[k] = w;
+        altos[k] = h;
+    }
+
+    generar(imagen->getPixels(), imagen->getWidth(), imagen->getHeight(), canales,
+            niveles, tipo, salidas.data(), anchos.data(), altos.data());
+
+    return resultado;
+}
+
+std::vector<PGMImage*> Pyramid::generarPiramide(const PGMImage* imagen, int niveles, PyramidType tipo) {
+    return generarPiramideImagen(imagen, niveles, tipo, 1, &Pyramid::generarNiveles);
+}
+
+std::vector<PPMImage*> Pyramid::generarPiramide(const PPMImage* imagen, int niveles, PyramidType tipo) {
+    return generarPiramideImagen(imagen, niveles, tipo, 3, &Pyramid::generarNiveles);
+}
+
+int Pyramid::nivelesMaximos(int width, int height) {
+    int niveles = 0;
+    while (width > 1 || height > 1) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        niveles++;
+    }
+    return niveles;
+}
+
+PyramidType Pyramid::stringToPyramidType(const char* nombre) {
+    if (strcmp(nombre, "box") == 0) {
+        return PYRAMID_BOX;
+    }
+    return PYRAMID_GAUSS; // Por defecto
+}
+
+const char* Pyramid::pyramidTypeToString(PyramidType tipo) {
+    switch (tipo) {
+        case PYRAMID_BOX: return "box";
+        case PYRAMID_GAUSS: return "gauss";
+        default: return "unknown";
+    }
+}
+
+void Pyramid::generarNiveles(const int* pixels, int width, int height, int canales,
+                             int niveles, PyramidType tipo,
+                             int* const* salidas, const int* anchos, const int* altos) {
+    // Banderas de "fila lista" por nivel para el pipeline entre niveles
+    std::vector<std::unique_ptr<std::atomic<unsigned char>[]> > listas(niveles);
+    std::vector<int> primera_tarea(niveles + 1);
+    primera_tarea[0] = 0;
+    for (int k = 0; k < niveles; k++) {
+        listas[k].reset(new std::atomic<unsigned char>[altos[k]]);
+        for (int y = 0; y < altos[k]; y++) {
+            listas[k][y].store(0, std::memory_order_relaxed);
+        }
+        primera_tarea[k + 1] = primera_tarea[k] + (altos[k] + FILAS_POR_TAREA - 1) / FILAS_POR_TAREA;
+    }
+    const int total_tareas = primera_tarea[niveles];
+
+    // Filas fuente que necesita la fila de salida y: [2y - arriba, 2y + abajo]
+    const int arriba = (tipo == PYRAMID_GAUSS) ? 2 : 0;
+    const int abajo = (tipo == PYRAMID_GAUSS) ? 2 : 1;
+
+    // Las tareas se reparten en orden global (nivel 1, nivel 2, ...). Como un hilo solo
+    // espera por filas de tareas anteriores, ya tomadas por otros hilos, no hay interbloqueo.
+    std::atomic<int> siguiente(0);
+
+    Parallel::enCadaHilo([&](int, int) {
+        std::vector<int> fila_tmp(width * canales);
+
+        while (true) {
+            int t = siguiente.fetch_add(1);
+            if (t >= total_tareas) {
+                break;
+            }
+
+            int k = 0;
+            while (t >= primera_tarea[k + 1]) {
+                k++;
+            }
+
+            const int* src = (k == 0) ? pixels : salidas[k - 1];
+            int src_w = (k == 0) ? width : anchos[k - 1];
+            int src_h = (k == 0) ? height : altos[k - 1];
+
+            int fila_ini = (t - primera_tarea[k]) * FILAS_POR_TAREA;
+            int fila_fin = std::min(fila_ini + FILAS_POR_TAREA, altos[k]);
+
+            for (int y = fila_ini; y < fila_fin; y++) {
+                if (k > 0) {
+                    // Esperar a que las filas fuente del nivel anterior estén listas
+                    int r_ini = std::max(0, 2 * y - arriba);
+                    int r_fin = std::min(src_h - 1, 2 * y + abajo);
+                    for (int r = r_ini; r <= r_fin; r++) {
+                        while (listas[k - 1][r].load(std::memory_order_acquire) == 0) {
+                            std::this_thread::yield();
+                        }
+                    }
+                }
+
+                reducirFila(src, src_w, src_h, salidas[k], anchos[k], y, canales, tipo, fila_tmp.data());
+                listas[k][y].store(1, std::memory_order_release);
+            }
+        }
+    });
+}
+
+void Pyramid::reducirFila(const int* src, int src_w, int src_h, int* dst, int dst_w,
+                          int y, int canales, PyramidType tipo, int* fila_tmp) {
+    const int n = src_w * canales;
+    int* fila_dst = dst + y * dst_w * canales;
+
+    if (tipo == PYRAMID_BOX) {
+        // Suma vertical de las filas 2y y 2y+1 (replicando el borde)
+        const int* r0 = src + (2 * y) * n;
+        const int* r1 = src + std::min(2 * y + 1, src_h - 1) * n;
+        for (int i = 0; i < n; i++) {
+            fila_tmp[i] = r0[i] + r1[i];
+        }
+
+        // Suma horizontal 2x1 y decimación
+        for (int x = 0; x < dst_w; x++) {
+            int x0 = 2 * x;
+            int x1 = std::min(2 * x + 1, src_w - 1);
+            for (int c = 0; c < canales; c++) {
+                int suma = fila_tmp[x0 * canales + c] + fila_tmp[x1 * canales + c];
+                fila_dst[x * canales + c] = (suma + 2) >> 2;
+            }
+        }
+        return;
+    }
+
+    // Gaussiano 5 taps vertical [1 4 6 4 1] (replicando el borde)
+    const int* r0 = src + std::max(2 * y - 2, 0) * n;
+    const int* r1 = src + std::max(2 * y - 1, 0) * n;
+    const int* r2 = src + (2 * y) * n;
+    const int* r3 = src + std::min(2 * y + 1, src_h - 1) * n;
+    const int* r4 = src + std::min(2 * y + 2, src_h - 1) * n;
+    for (int i = 0; i < n; i++) {
+        fila_tmp[i] = r0[i] + 4 * (r1[i] + r3[i]) + 6 * r2[i] + r4[i];
+    }
+
+    // Gaussiano 5 taps horizontal y decimación; el peso total es 16 * 16 = 256
+    for (int x = 0; x < dst_w; x++) {
+        int xc = 2 * x;
+        int c0 = std::max(xc - 2, 0) * canales;
+        int c1 = std::max(xc - 1, 0) * canales;
+        int c2 = xc * canales;
+        int c3 = std::min(xc + 1, src_w - 1) * canales;
+        int c4 = std::min(xc + 2, src_w - 1) * canales;
+        for (int c = 0; c < canales; c++) {
+            int suma = fila_tmp[c0 + c] + 4 * (fila_tmp[c1 + c] + fila_tmp[c3 + c])
+                     + 6 * fila_tmp[c2 + c] + fila_tmp[c4 + c];
+            fila_dst[x * canales + c] = (suma + 128) >> 8;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef PYRAMID_H
+#define PYRAMID_H
+
+#include <vector>
+#include "PGMimage.h"
+#include "PPMimage.h"
+
+enum PyramidType {
+    PYRAMID_BOX,    // Promedio 2x2 + decimación
+    PYRAMID_GAUSS   // Gaussiano 5 taps [1 4 6 4 1]/16 + decimación
+};
+
+class Pyramid {
+public:
+    // Generar los niveles 1..niveles de la pirámide (el nivel 0 es la imagen original).
+    // Cada nivel mide la mitad (redondeando hacia arriba) del anterior.
+    // El llamador es dueño de las imágenes devueltas; vector vacío en caso de error.
+    static std::vector<PGMImage*> generarPiramide(const PGMImage* imagen, int niveles, PyramidType tipo);
+    static std::vector<PPMImage*> generarPiramide(const PPMImage* imagen, int niveles, PyramidType tipo);
+
+    // Número máximo de niveles hasta llegar a 1x1
+    static int nivelesMaximos(int width, int height);
+
+    // Conversión de string a PyramidType
+    static PyramidType stringToPyramidType(const char* nombre);
+    static const char* pyramidTypeToString(PyramidType tipo);
+
+private:
+    // Generar todos los niveles sobre buffers ya reservados.
+    // Los niveles se procesan en paralelo por filas y en pipeline entre niveles:
+    // una fila del nivel k+1 se calcula en cuanto sus filas fuente del nivel k están listas.
+    static void generarNiveles(const int* pixels, int width, int height, int canales,
+                               int niveles, PyramidType tipo,
+                               int* const* salidas, const int* anchos, const int* altos);
+
+    // Calcular una fila de salida fusionando suavizado vertical, horizontal y decimación
+    static void reducirFila(const int* src, int src_w, int src_h, int* dst, int dst_w,
+                            int y, int canales, PyramidType tipo, int* fila_tmp);
+};
+
+#endif
\ No newline at end of file
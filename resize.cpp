@@ -0,0 +1,230 @@
+#include "resize.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const double PI = 3.14159265358979323846;
+
+static double sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    double px = PI * x;
+    return std::sin(px) / px;
+}
+
+static double lanczos3(double x) {
+    x = std::fabs(x);
+    return (x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+// Producto punto de 'taps' muestras (múltiplo de 4) con sus pesos
+static inline float productoPunto(const float* muestras, const float* pesos, int taps) {
+#ifdef __SSE2__
+    __m128 suma = _mm_setzero_ps();
+    for (int k = 0; k < taps; k += 4) {
+        suma = _mm_add_ps(suma, _mm_mul_ps(_mm_loadu_ps(muestras + k), _mm_loadu_ps(pesos + k)));
+    }
+    alignas(16) float parcial[4];
+    _mm_store_ps(parcial, suma);
+    return (parcial[0] + parcial[1]) + (parcial[2] + parcial[3]);
+#else
+    float suma = 0.0f;
+    for (int k = 0; k < taps; k++) {
+        suma += muestras[k] * pesos[k];
+    }
+    return suma;
+#endif
+}
+
+// acc[i] += peso * fila[i]
+static inline void acumularFila(float* acc, const float* fila, float peso, int n) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128 w = _mm_set1_ps(peso);
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_loadu_ps(acc + i);
+        _mm_storeu_ps(acc + i, _mm_add_ps(a, _mm_mul_ps(w, _mm_loadu_ps(fila + i))));
+    }
+#endif
+    for (; i < n; i++) {
+        acc[i] += peso * fila[i];
+    }
+}
+
+template<typename ImagenT>
+static ImagenT* redimensionarImagen(const ImagenT* imagen, int ancho, int alto, ResizeType tipo, int canales,
+                                    void (*remuestrear)(const int*, int, int, int*, int, int, int, int, ResizeType)) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return nullptr;
+    }
+
+    int src_w = imagen->getWidth();
+    int src_h = imagen->getHeight();
+
+    // Conservar la proporción si una dimensión es 0
+    if (ancho <= 0 && alto <= 0) {
+        return nullptr;
+    } else if (ancho <= 0) {
+        ancho = std::max(1, static_cast<int>(std::lround(static_cast<double>(src_w) * alto / src_h)));
+    } else if (alto <= 0) {
+        alto = std::max(1, static_cast<int>(std::lround(static_cast<double>(src_h) * ancho / src_w)));
+    }
+
+    ImagenT* resultado = imagen->crearImagenVacia(ancho, alto);
+    if (resultado == nullptr) {
+        return nullptr;
+    }
+
+    remuestrear(imagen->getPixels(), src_w, src_h, resultado->getPixels(), ancho, alto,
+                canales, imagen->getMaxColor(), tipo);
+    return resultado;
+}
+
+PGMImage* Resize::redimensionar(const PGMImage* imagen, int ancho, int alto, ResizeType tipo) {
+    return redimensionarImagen(imagen, ancho, alto, tipo, 1, &Resize::remuestrear);
+}
+
+PPMImage* Resize::redimensionar(const PPMImage* imagen, int ancho, int alto, ResizeType tipo) {
+    return redimensionarImagen(imagen, ancho, alto, tipo, 3, &Resize::remuestrear);
+}
+
+ResizeType Resize::stringToResizeType(const char* nombre) {
+    if (strcmp(nombre, "lanczos") == 0 || strcmp(nombre, "lanczos3") == 0) {
+        return RESIZE_LANCZOS3;
+    }
+    return RESIZE_AREA; // Por defecto
+}
+
+const char* Resize::resizeTypeToString(ResizeType tipo) {
+    switch (tipo) {
+        case RESIZE_AREA: return "area";
+        case RESIZE_LANCZOS3: return "lanczos3";
+        default: return "unknown";
+    }
+}
+
+ResizeCoefs Resize::calcularCoeficientes(int tam_fuente, int tam_destino, ResizeType tipo) {
+    const double escala = static_cast<double>(tam_fuente) / tam_destino;
+    std::vector<int> primeras(tam_destino), ultimas(tam_destino);
+
+    // Ventana de muestras fuente de cada posición de salida
+    const double escala_filtro = std::max(escala, 1.0);
+    const double radio = 3.0 * escala_filtro;
+    int max_taps = 1;
+    for (int i = 0; i < tam_destino; i++) {
+        if (tipo == RESIZE_AREA) {
+            double lo = i * escala;
+            double hi = (i + 1) * escala;
+            primeras[i] = static_cast<int>(std::floor(lo));
+            ultimas[i] = std::min(tam_fuente - 1, static_cast<int>(std::ceil(hi)) - 1);
+        } else {
+            double centro = (i + 0.5) * escala - 0.5;
+            primeras[i] = static_cast<int>(std::ceil(centro - radio));
+            ultimas[i] = static_cast<int>(std::floor(centro + radio));
+        }
+        ultimas[i] = std::max(ultimas[i], primeras[i]);
+        max_taps = std::max(max_taps, ultimas[i] - primeras[i] + 1);
+    }
+
+    ResizeCoefs coefs;
+    coefs.taps = (max_taps + 3) & ~3;
+    coefs.inicio = primeras;
+    coefs.pesos.assign(static_cast<size_t>(tam_destino) * coefs.taps, 0.0f);
+
+    for (int i = 0; i < tam_destino; i++) {
+        float* pesos = coefs.pesos.data() + static_cast<size_t>(i) * coefs.taps;
+        double suma = 0.0;
+        for (int j = primeras[i]; j <= ultimas[i]; j++) {
+            double w;
+            if (tipo == RESIZE_AREA) {
+                // Superposición de la muestra [j, j+1) con el intervalo de salida
+                double lo = i * escala;
+                double hi = (i + 1) * escala;
+                w = std::max(0.0, std::min(hi, j + 1.0) - std::max(lo, static_cast<double>(j)));
+            } else {
+                double centro = (i + 0.5) * escala - 0.5;
+                w = lanczos3((j - centro) / escala_filtro);
+            }
+            pesos[j - primeras[i]] = static_cast<float>(w);
+            suma += w;
+        }
+
+        // Normalizar para que los pesos sumen 1
+        if (suma != 0.0) {
+            for (int k = 0; k < coefs.taps; k++) {
+                pesos[k] = static_cast<float>(pesos[k] / suma);
+            }
+        }
+    }
+
+    return coefs;
+}
+
+void Resize::remuestrear(const int* src, int src_w, int src_h, int* dst, int dst_w, int dst_h,
+                         int canales, int max_color, ResizeType tipo) {
+    const ResizeCoefs horizontal = calcularCoeficientes(src_w, dst_w, tipo);
+    const ResizeCoefs vertical = calcularCoeficientes(src_h, dst_h, tipo);
+
+    const int fila_tmp = dst_w * canales;
+    std::vector<float> tmp(static_cast<size_t>(src_h) * fila_tmp);
+
+    // Pasada horizontal: cada fila fuente se separa en planos por canal con borde replicado,
+    // de modo que la ventana de cada columna de salida es contigua
+    const int relleno = horizontal.taps;
+    const int largo_plano = src_w + 2 * relleno;
+    Parallel::paraRango(src_h, [&](int inicio, int fin) {
+        std::vector<float> planos(static_cast<size_t>(canales) * largo_plano);
+        for (int y = inicio; y < fin; y++) {
+            const int* fila = src + static_cast<size_t>(y) * src_w * canales;
+            for (int c = 0; c < canales; c++) {
+                float* plano = planos.data() + c * largo_plano;
+                for (int j = 0; j < src_w; j++) {
+                    plano[relleno + j] = static_cast<float>(fila[j * canales + c]);
+                }
+                for (int j = 0; j < relleno; j++) {
+                    plano[j] = plano[relleno];
+                    plano[relleno + src_w + j] = plano[relleno + src_w - 1];
+                }
+            }
+
+            float* salida = tmp.data() + static_cast<size_t>(y) * fila_tmp;
+            for (int x = 0; x < dst_w; x++) {
+                const float* pesos = horizontal.pesos.data() + static_cast<size_t>(x) * horizontal.taps;
+                int base = relleno + horizontal.inicio[x];
+                for (int c = 0; c < canales; c++) {
+                    salida[x * canales + c] = productoPunto(planos.data() + c * largo_plano + base,
+                                                            pesos, horizontal.taps);
+                }
+            }
+        }
+    });
+
+    // Pasada vertical: combinación lineal de filas intermedias completas
+    Parallel::paraRango(dst_h, [&](int inicio, int fin) {
+        std::vector<float> acc(fila_tmp);
+        for (int y = inicio; y < fin; y++) {
+            std::fill(acc.begin(), acc.end(), 0.0f);
+            const float* pesos = vertical.pesos.data() + static_cast<size_t>(y) * vertical.taps;
+            for (int k = 0; k < vertical.taps; k++) {
+                if (pesos[k] == 0.0f) {
+                    continue;
+                }
+                int r = std::max(0, std::min(src_h - 1, vertical.inicio[y] + k));
+                acumularFila(acc.data(), tmp.data() + static_cast<size_t>(r) * fila_tmp, pesos[k], fila_tmp);
+            }
+
+            int* salida = dst + static_cast<size_t>(y) * fila_tmp;
+            const float maximo = static_cast<float>(max_color);
+            for (int i = 0; i < fila_tmp; i++) {
+                float v = std::max(0.0f, std::min(maximo, acc[i]));
+                salida[i] = static_cast<int>(v + 0.5f);
+            }
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef RESIZE_H
+#define RESIZE_H
+
+#include <vector>
+#include "PGMimage.h"
+#include "PPMimage.h"
+
+enum ResizeType {
+    RESIZE_AREA,     // Promedio por área (box)
+    RESIZE_LANCZOS3  // Lanczos con 3 lóbulos
+};
+
+// Coeficientes de remuestreo de un eje: para cada posición de salida,
+// primera muestra fuente y 'taps' pesos (rellenados con ceros a múltiplo de 4)
+struct ResizeCoefs {
+    int taps;
+    std::vector<int> inicio;
+    std::vector<float> pesos;   // salida * taps
+};
+
+class Resize {
+public:
+    // Redimensionar a ancho x alto. Si uno de los dos es 0 se conserva la proporción.
+    static PGMImage* redimensionar(const PGMImage* imagen, int ancho, int alto, ResizeType tipo);
+    static PPMImage* redimensionar(const PPMImage* imagen, int ancho, int alto, ResizeType tipo);
+
+    // Conversión de string a ResizeType
+    static ResizeType stringToResizeType(const char* nombre);
+    static const char* resizeTypeToString(ResizeType tipo);
+
+    // Precalcular los coeficientes de un eje de tamaño_fuente a tamaño_destino
+    static ResizeCoefs calcularCoeficientes(int tam_fuente, int tam_destino, ResizeType tipo);
+
+private:
+    // Remuestreo separable: pasada horizontal sobre filas fuente y vertical sobre filas destino,
+    // ambas paralelas por bandas de filas
+    static void remuestrear(const int* src, int src_w, int src_h, int* dst, int dst_w, int dst_h,
+                            int canales, int max_color, ResizeType tipo);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "scheduler.h"
+#include <algorithm>
+
+BandScheduler::BandScheduler(ThreadPool& p, int filas) : pool(p), filas_por_banda(filas > 0 ? filas : 1) {
+}
+
+int BandScheduler::bandaPorDefecto(int alto, int num_hilos) {
+    return std::max(4, alto / (std::max(1, num_hilos) * 8));
+}
+
+bool BandScheduler::tomarFrente(Deque& deque, int& banda) {
+    uint64_t actual = deque.rango.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t frente = static_cast<uint32_t>(actual >> 32);
+        uint32_t final_ = static_cast<uint32_t>(actual);
+        if (frente >= final_) {
+            return false;
+        }
+        if (deque.rango.compare_exchange_weak(actual, empaquetar(frente + 1, final_),
+                                              std::memory_order_acq_rel)) {
+            banda = static_cast<int>(frente);
+            return true;
+        }
+    }
+}
+
+bool BandScheduler::robarFinal(Deque& deque, int& banda) {
+    uint64_t actual = deque.rango.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t frente = static_cast<uint32_t>(actual >> 32);
+        uint32_t final_ = static_cast<uint32_t>(actual);
+        if (frente >= final_) {
+            return false;
+        }
+        if (deque.rango.compare_exchange_weak(actual, empaquetar(frente, final_ - 1),
+                                              std::memory_order_acq_rel)) {
+            banda = static_cast<int>(final_ - 1);
+            return true;
+        }
+    }
+}
+
+void BandScheduler::recorrerReparto(int alto, const std::function<void(int, int, int)>& func) {
+    const int num_bandas = (alto + filas_por_banda - 1) / filas_por_banda;
+
+    pool.ejecutar([&](int id, int total) {
+        int primera = static_cast<int>(static_cast<long long>(num_bandas) * id / total);
+        int ultima = static_cast<int>(static_cast<long long>(num_bandas) * (id + 1) / total);
+        int fila_ini = primera * filas_por_banda;
+        int fila_fin = std::min(ultima * filas_por_banda, alto);
+        if (fila_ini < fila_fin) {
+            func(fila_ini, fila_fin, id);
+        }
+    });
+}
+
+void BandScheduler::ejecutar(int alto, const std::function<void(int, int, int)>& func,
+                             std::vector<Timer>* timers_hilos,
+                             std::vector<PerfCounters>* contadores_hilos) {
+    const int num_hilos = pool.getNumHilos();
+    const int num_bandas = (alto + filas_por_banda - 1) / filas_por_banda;
+
+    // Reparto inicial: bandas contiguas por trabajador
+    std::vector<Deque> deques(num_hilos);
+    for (int i = 0; i < num_hilos; i++) {
+        uint32_t frente = static_cast<uint32_t>(static_cast<long long>(num_bandas) * i / num_hilos);
+        uint32_t final_ = static_cast<uint32_t>(static_cast<long long>(num_bandas) * (i + 1) / num_hilos);
+        deques[i].rango.store(empaquetar(frente, final_), std::memory_order_relaxed);
+    }
+
+    estadisticas.assign(num_hilos, WorkerStats());
+    Timer reloj;
+    reloj.start();
+
+    pool.ejecutar([&](int id, int) {
+        if (timers_hilos != nullptr) {
+            (*timers_hilos)[id].start();
+        }
+        if (contadores_hilos != nullptr) {
+            (*contadores_hilos)[id].start();
+        }
+        WorkerStats& stats = estadisticas[id];
+        stats.ocupado_ms = 0.0;
+        stats.bandas = 0;
+        stats.robadas = 0;
+
+        auto procesar = [&](int banda) {
+            double inicio = reloj.getElapsedMilliseconds();
+            int fila_ini = banda * filas_por_banda;
+            int fila_fin = std::min(fila_ini + filas_por_banda, alto);
+            func(fila_ini, fila_fin, id);
+            stats.ocupado_ms += reloj.getElapsedMilliseconds() - inicio;
+            stats.bandas++;
+        };
+
+        int banda;
+        while (true) {
+            // Primero el deque propio, en orden (favorece el prefetch)
+            while (tomarFrente(deques[id], banda)) {
+                procesar(banda);
+            }
+
+            // Robar por el final de la víctima con más trabajo pendiente
+            int victima = -1;
+            uint32_t mayor = 0;
+            for (int v = 0; v < num_hilos; v++) {
+                uint64_t r = deques[v].rango.load(std::memory_order_relaxed);
+                uint32_t pendientes = static_cast<uint32_t>(r) - std::min(static_cast<uint32_t>(r),
+                                                                          static_cast<uint32_t>(r >> 32));
+                if (pendientes > mayor) {
+                    mayor = pendientes;
+                    victima = v;
+                }
+            }
+            if (victima < 0) {
+                break;
+            }
+            if (robarFinal(deques[victima], banda)) {
+                stats.robadas++;
+                procesar(banda);
+            }
+        }
+
+        if (contadores_hilos != nullptr) {
+            (*contadores_hilos)[id].stop();
+        }
+        if (timers_hilos != nullptr) {
+            (*timers_hilos)[id].stop();
+        }
+    });
+
+    reloj.stop();
+    double total = reloj.getElapsedMilliseconds();
+    for (int i = 0; i < num_hilos; i++) {
+        estadisticas[i].inactivo_ms = std::max(0.0, total - estadisticas[i].ocupado_ms);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "perfcounters.h"
+#include "threadpool.h"
+#include "timer.h"
+
+// Métricas de un trabajador en la última ejecución
+struct WorkerStats {
+    double ocupado_ms;    // Tiempo procesando bandas
+    double inactivo_ms;   // Tiempo buscando trabajo o esperando al resto
+    int bandas;           // Bandas procesadas (propias + robadas)
+    int robadas;          // Bandas robadas a otros trabajadores
+};
+
+// Planificador de bandas de filas de ancho completo con robo de trabajo.
+// Cada trabajador recibe un rango contiguo de bandas (su deque): las toma por el frente
+// en orden y, cuando se le acaban, roba por el final del deque de otro trabajador.
+class BandScheduler {
+public:
+    BandScheduler(ThreadPool& pool, int filas_por_banda);
+
+    // Ejecutar func(fila_ini, fila_fin, id_hilo) sobre todas las bandas de [0, alto).
+    // Si se pasa timers_hilos, cada trabajador mide en su timer su tiempo total en el trabajo;
+    // con contadores_hilos, además cuenta sus eventos hardware en esa región.
+    void ejecutar(int alto, const std::function<void(int, int, int)>& func,
+                  std::vector<Timer>* timers_hilos = nullptr,
+                  std::vector<PerfCounters>* contadores_hilos = nullptr);
+
+    // Ejecutar func(fila_ini, fila_fin, id_hilo) sobre el reparto inicial de bandas, sin robo.
+    // Sirve para colocar datos (primer contacto) donde luego se procesarán.
+    void recorrerReparto(int alto, const std::function<void(int, int, int)>& func);
+
+    int getFilasPorBanda() const { return filas_por_banda; }
+    void setFilasPorBanda(int filas) { filas_por_banda = filas > 0 ? filas : 1; }
+    const std::vector<WorkerStats>& getEstadisticas() const { return estadisticas; }
+
+    // Tamaño de banda por defecto: unas 8 bandas por trabajador
+    static int bandaPorDefecto(int alto, int num_hilos);
+
+private:
+    // Deque de un trabajador: rango [frente, final) de índices de banda empaquetado
+    // en una palabra de 64 bits, de modo que dueño y ladrones se coordinan con CAS
+    struct Deque {
+        std::atomic<uint64_t> rango;
+        char relleno[64 - sizeof(std::atomic<uint64_t>)];   // Evitar false sharing
+    };
+
+    static uint64_t empaquetar(uint32_t frente, uint32_t final_) {
+        return (static_cast<uint64_t>(frente) << 32) | final_;
+    }
+
+    bool tomarFrente(Deque& deque, int& banda);
+    bool robarFinal(Deque& deque, int& banda);
+
+    ThreadPool& pool;
+    int filas_por_banda;
+    std::vector<WorkerStats> estadisticas;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "stats.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+
+ImageStats::ImageStats() : canales(0), max_color(0), muestras(0) {
+    for (int c = 0; c < 3; c++) {
+        minimo[c] = 0;
+        maximo[c] = 0;
+        media[c] = 0.0;
+        desviacion[c] = 0.0;
+    }
+}
+
+const long long* ImageStats::getHistograma(int canal) const {
+    return histograma.data() + static_cast<size_t>(canal) * (max_color + 1);
+}
+
+int ImageStats::percentil(int canal, double p) const {
+    if (muestras == 0) {
+        return 0;
+    }
+
+    const long long* hist = getHistograma(canal);
+    double objetivo = std::max(0.0, std::min(100.0, p)) / 100.0 * muestras;
+    long long acumulado = 0;
+    for (int v = 0; v <= max_color; v++) {
+        acumulado += hist[v];
+        if (acumulado > 0 && acumulado >= objetivo) {
+            return v;
+        }
+    }
+    return max_color;
+}
+
+ImageStats Statistics::calcular(const PGMImage* imagen) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return ImageStats();
+    }
+    return calcularHistograma(imagen->getPixels(), imagen->getPixelCount(), 1, imagen->getMaxColor());
+}
+
+ImageStats Statistics::calcular(const PPMImage* imagen) {
+    if (imagen == nullptr || imagen->getPixels() == nullptr) {
+        return ImageStats();
+    }
+    return calcularHistograma(imagen->getPixels(), imagen->getPixelCount(), 3, imagen->getMaxColor());
+}
+
+ImageStats Statistics::calcularHistograma(const int* pixels, int muestras, int canales, int max_color) {
+    ImageStats stats;
+    stats.canales = canales;
+    stats.max_color = max_color;
+    stats.muestras = muestras / canales;
+
+    const int bins = max_color + 1;
+    const int total_bins = canales * bins;
+    const int num_hilos = Parallel::getNumHilos();
+
+    // Histogramas privados por hilo: cada hilo escribe solo en el suyo
+    std::vector<long long> privados(static_cast<size_t>(num_hilos) * total_bins, 0);
+    // Píxeles completos por hilo para que cada bloque empiece en el canal 0
+    const int num_pixeles = muestras / canales;
+
+    Parallel::enCadaHilo([&](int id, int total) {
+        long long* hist = privados.data() + static_cast<size_t>(id) * total_bins;
+        int bloque = num_pixeles / total;
+        int extra = num_pixeles % total;
+        int inicio = id * bloque + std::min(id, extra);
+        int fin = inicio + bloque + (id < extra ? 1 : 0);
+
+        for (int p = inicio; p < fin; p++) {
+            for (int c = 0; c < canales; c++) {
+                int v = std::max(0, std::min(max_color, pixels[p * canales + c]));
+                hist[c * bins + v]++;
+            }
+        }
+    });
+
+    // Reducción: cada hilo suma un rango de bins de todos los histogramas privados
+    stats.histograma.assign(total_bins, 0);
+    Parallel::paraRango(total_bins, [&](int inicio, int fin) {
+        for (int t = 0; t < num_hilos; t++) {
+            const long long* hist = privados.data() + static_cast<size_t>(t) * total_bins;
+            for (int b = inicio; b < fin; b++) {
+                stats.histograma[b] += hist[b];
+            }
+        }
+    });
+
+    // Momentos y extremos a partir del histograma
+    for (int c = 0; c < canales; c++) {
+        const long long* hist = stats.getHistograma(c);
+        double suma = 0.0, suma_cuadrados = 0.0;
+        int minimo = -1, maximo = 0;
+        for (int v = 0; v < bins; v++) {
+            if (hist[v] == 0) {
+                continue;
+            }
+            if (minimo < 0) {
+                minimo = v;
+            }
+            maximo = v;
+            suma += static_cast<double>(v) * hist[v];
+            suma_cuadrados += static_cast<double>(v) * v * hist[v];
+        }
+
+        stats.minimo[c] = std::max(minimo, 0);
+        stats.maximo[c] = maximo;
+        if (stats.muestras > 0) {
+            stats.media[c] = suma / stats.muestras;
+            double varianza = suma_cuadrados / stats.muestras - stats.media[c] * stats.media[c];
+            stats.desviacion[c] = std::sqrt(std::max(varianza, 0.0));
+        }
+    }
+
+    return stats;
+}
+
+void Statistics::imprimir(const ImageStats& stats) {
+    static const char* nombres_rgb[3] = {"R", "G", "B"};
+
+    std::cout << "Muestras por canal: " << stats.muestras << std::endl;
+    for (int c = 0; c < stats.canales; c++) {
+        const char* nombre = (stats.canales == 1) ? "Gris" : nombres_rgb[c];
+        std::cout << "Canal " << nombre << ": min=" << stats.minimo[c]
+                  << " max=" << stats.maximo[c]
+                  << " media=" << stats.media[c]
+                  << " desv=" << stats.desviacion[c]
+                  << " p1=" << stats.percentil(c, 1.0)
+                  << " p50=" << stats.percentil(c, 50.0)
+                  << " p99=" << stats.percentil(c, 99.0) << std::endl;
+    }
+}
\ No newline at end of file
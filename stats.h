@@ -0,0 +1,42 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <vector>
+#include "PGMimage.h"
+#include "PPMimage.h"
+
+// Estadísticas por canal de una imagen (1 canal para PGM, 3 para PPM)
+struct ImageStats {
+    int canales;
+    int max_color;
+    long long muestras;                 // Muestras por canal
+    std::vector<long long> histograma;  // canales * (max_color + 1) bins, canal mayor
+    int minimo[3];
+    int maximo[3];
+    double media[3];
+    double desviacion[3];
+
+    ImageStats();
+
+    // Histograma de un canal (max_color + 1 bins)
+    const long long* getHistograma(int canal) const;
+
+    // Menor valor v tal que el porcentaje p (0-100) de las muestras es <= v
+    int percentil(int canal, double p) const;
+};
+
+class Statistics {
+public:
+    // Calcular histograma, min/max, media y desviación estándar.
+    // Cada hilo llena un histograma privado y luego se reducen por rangos de bins (sin atómicos).
+    static ImageStats calcular(const PGMImage* imagen);
+    static ImageStats calcular(const PPMImage* imagen);
+
+    // Imprimir resumen de estadísticas
+    static void imprimir(const ImageStats& stats);
+
+private:
+    static ImageStats calcularHistograma(const int* pixels, int muestras, int canales, int max_color);
+};
+
+#endif
\ No newline at end of file
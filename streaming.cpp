@@ -0,0 +1,214 @@
+#include "streaming.h"
+#include "pnmtext.h"
+#include "timer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Espera activa con cesión del procesador y, si se alarga, pausas cortas
+static void esperar(int& intentos) {
+    if (intentos < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    intentos++;
+}
+
+bool BandStreamer::filtrar(const char* entrada, const char* salida, FilterType tipo,
+                           int filas_por_banda, int hilos_filtro, StreamStats& stats) {
+    if (!Filter::esConvolucion(tipo)) {
+        std::cerr << "Error: El modo streaming solo admite filtros de convolución" << std::endl;
+        return false;
+    }
+
+    Timer timer_total;
+    timer_total.start();
+
+    FILE* file = fopen(entrada, "r");
+    if (file == nullptr) {
+        std::cerr << "Error: No se pudo abrir el archivo " << entrada << std::endl;
+        return false;
+    }
+
+    // La cabecera se lee antes de arrancar los hilos: fija dimensiones y buffers
+    LectorPNM lector(file);
+    char magic[3];
+    int width, height, max_color;
+    if (!lector.leerMagico(magic) || !lector.leerEntero(width) || !lector.leerEntero(height)
+        || !lector.leerEntero(max_color) || width <= 0 || height <= 0) {
+        std::cerr << "Error: No se pudo leer la cabecera de " << entrada << std::endl;
+        fclose(file);
+        return false;
+    }
+    int canales;
+    if (strcmp(magic, "P2") == 0) {
+        canales = 1;
+    } else if (strcmp(magic, "P3") == 0) {
+        canales = 3;
+    } else {
+        std::cerr << "Error: Formato no soportado (" << magic << "), use P2 o P3" << std::endl;
+        fclose(file);
+        return false;
+    }
+
+    FILE* output = fopen(salida, "w");
+    if (output == nullptr) {
+        std::cerr << "Error: No se pudo crear el archivo " << salida << std::endl;
+        fclose(file);
+        return false;
+    }
+
+    const int stride = width * canales;
+    int* pixels = (int*)malloc(static_cast<size_t>(height) * stride * sizeof(int));
+    int* resultado = (int*)malloc(static_cast<size_t>(height) * stride * sizeof(int));
+    if (pixels == nullptr || resultado == nullptr) {
+        std::cerr << "Error: No se pudo reservar memoria para los píxeles" << std::endl;
+        free(pixels);
+        free(resultado);
+        fclose(file);
+        fclose(output);
+        remove(salida);
+        return false;
+    }
+
+    filas_por_banda = std::max(1, filas_por_banda);
+    hilos_filtro = std::max(1, hilos_filtro);
+    const int num_bandas = (height + filas_por_banda - 1) / filas_por_banda;
+
+    std::atomic<int> filas_leidas(0);
+    std::atomic<int> siguiente_banda(0);
+    std::atomic<bool> error(false);
+    std::unique_ptr<std::atomic<unsigned char>[]> banda_lista(new std::atomic<unsigned char>[num_bandas]);
+    for (int b = 0; b < num_bandas; b++) {
+        banda_lista[b].store(0, std::memory_order_relaxed);
+    }
+    std::vector<double> filtrado_hilo(hilos_filtro, 0.0);
+
+    // Lector: parsea fila a fila y publica cuántas filas completas hay (nunca una a medias)
+    Timer timer_carga;
+    std::thread lector_hilo([&]() {
+        timer_carga.start();
+        for (int y = 0; y < height && !error.load(std::memory_order_relaxed); y++) {
+            int* fila = pixels + static_cast<size_t>(y) * stride;
+            for (int i = 0; i < stride; i++) {
+                if (!lector.leerEntero(fila[i])) {
+                    std::cerr << "Error: No se pudieron leer los píxeles" << std::endl;
+                    error.store(true);
+                    timer_carga.stop();
+                    return;
+                }
+            }
+            filas_leidas.store(y + 1, std::memory_order_release);
+        }
+        timer_carga.stop();
+    });
+
+    // Filtrado: las bandas se toman en orden; cada una espera a su última fila + 1 de halo
+    std::vector<std::thread> filtros;
+    for (int h = 0; h < hilos_filtro; h++) {
+        filtros.push_back(std::thread([&, h]() {
+            while (true) {
+                int b = siguiente_banda.fetch_add(1);
+                if (b >= num_bandas) {
+                    break;
+                }
+                int fila_ini = b * filas_por_banda;
+                int fila_fin = std::min(fila_ini + filas_por_banda, height);
+                int necesarias = std::min(fila_fin + 1, height);
+
+                int intentos = 0;
+                while (filas_leidas.load(std::memory_order_acquire) < necesarias) {
+                    if (error.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    esperar(intentos);
+                }
+
+                Timer timer;
+                timer.start();
+                Filter::filtrarRegion(pixels, width, height, canales, max_color, tipo,
+                                      0, fila_ini, width, fila_fin,
+                                      resultado + static_cast<size_t>(fila_ini) * stride, stride);
+                timer.stop();
+                filtrado_hilo[h] += timer.getElapsedMilliseconds();
+                banda_lista[b].store(1, std::memory_order_release);
+            }
+        }));
+    }
+
+    // Escritor (hilo actual): cabecera y bandas en orden según van terminando
+    double guardado_ms = 0.0;
+    double primera_banda_ms = 0.0;
+    {
+        Timer timer;
+        timer.start();
+        fprintf(output, "%s\n%d %d\n%d\n", magic, width, height, max_color);
+        timer.stop();
+        guardado_ms += timer.getElapsedMilliseconds();
+    }
+
+    std::vector<char> texto;
+    for (int b = 0; b < num_bandas && !error.load(); b++) {
+        int intentos = 0;
+        while (banda_lista[b].load(std::memory_order_acquire) == 0 && !error.load(std::memory_order_relaxed)) {
+            esperar(intentos);
+        }
+        if (error.load()) {
+            break;
+        }
+
+        Timer timer;
+        timer.start();
+        int fila_ini = b * filas_por_banda;
+        int fila_fin = std::min(fila_ini + filas_por_banda, height);
+        const int* origen = resultado + static_cast<size_t>(fila_ini) * stride;
+        size_t n = static_cast<size_t>(fila_fin - fila_ini) * stride;
+        if (!EscritorPNM::escribirMuestras(output, origen, n, texto)) {
+            std::cerr << "Error guardando imagen" << std::endl;
+            error.store(true);
+        }
+        timer.stop();
+        guardado_ms += timer.getElapsedMilliseconds();
+        if (b == 0) {
+            primera_banda_ms = timer_total.getElapsedMilliseconds();
+        }
+    }
+
+    lector_hilo.join();
+    for (size_t i = 0; i < filtros.size(); i++) {
+        filtros[i].join();
+    }
+
+    bool correcto = !error.load();
+    if (fclose(output) != 0) {
+        correcto = false;
+    }
+    if (!correcto) {
+        // No dejar en disco una salida a medias (los demás modos no llegan a crearla)
+        remove(salida);
+    }
+    fclose(file);
+    free(pixels);
+    free(resultado);
+
+    timer_total.stop();
+
+    stats.bandas = num_bandas;
+    stats.carga_ms = timer_carga.getElapsedMilliseconds();
+    stats.filtrado_ms = 0.0;
+    for (int h = 0; h < hilos_filtro; h++) {
+        stats.filtrado_ms += filtrado_hilo[h];
+    }
+    stats.guardado_ms = guardado_ms;
+    stats.primera_banda_ms = primera_banda_ms;
+    stats.total_ms = timer_total.getElapsedMilliseconds();
+    return correcto;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include "filter.h"
+
+// Tiempos de una ejecución en streaming
+struct StreamStats {
+    int bandas;
+    double carga_ms;          // Hilo lector: lectura y parseo de todo el archivo
+    double filtrado_ms;       // Suma del tiempo de filtrado de todas las bandas
+    double guardado_ms;       // Hilo escritor: formateo y escritura (sin contar esperas)
+    double primera_banda_ms;  // Desde el inicio hasta que la primera banda está escrita
+    double total_ms;          // Tiempo de pared de principio a fin
+};
+
+// Filtrado en streaming por bandas de filas para archivos PGM (P2) y PPM (P3).
+// Un hilo lee y parsea el archivo; en cuanto la banda k y su fila de halo están parseadas,
+// los hilos de filtrado la procesan, y un hilo escritor vuelca las bandas terminadas en orden.
+// Así carga, filtrado y guardado se solapan y el tiempo total tiende al máximo de los tres.
+class BandStreamer {
+public:
+    // Solo filtros de convolución 3x3 (locales). La salida es idéntica a la de
+    // cargarImagen + aplicarFiltro + guardarImagen.
+    static bool filtrar(const char* entrada, const char* salida, FilterType tipo,
+                        int filas_por_banda, int hilos_filtro, StreamStats& stats);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "threadpool.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+ThreadPool* ThreadPool::pool_global = nullptr;
+int ThreadPool::tamano_global = 0;
+
+static thread_local bool hilo_del_pool = false;
+
+// Protege la creación y la sustitución del pool global
+static pthread_mutex_t mutex_global = PTHREAD_MUTEX_INITIALIZER;
+
+ThreadPool::ThreadPool(int n) : num_hilos(n > 0 ? n : 1), trabajo(nullptr),
+                                generacion(0), pendientes(0), terminar(false) {
+    pthread_mutex_init(&mutex, nullptr);
+    pthread_cond_init(&cond_trabajo, nullptr);
+    pthread_cond_init(&cond_fin, nullptr);
+    pthread_mutex_init(&mutex_ejecucion, nullptr);
+
+    // El hilo 0 es el llamador de ejecutar(); se crean num_hilos - 1 trabajadores
+    args.resize(num_hilos);
+    hilos.reserve(num_hilos);
+    for (int i = 1; i < num_hilos; i++) {
+        args[i].pool = this;
+        args[i].id = i;
+        pthread_t hilo;
+        if (pthread_create(&hilo, nullptr, bucleTrabajador, &args[i]) != 0) {
+            std::cerr << "Error creando thread " << i << " del pool" << std::endl;
+            num_hilos = i;
+            break;
+        }
+        hilos.push_back(hilo);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    pthread_mutex_lock(&mutex);
+    terminar = true;
+    pthread_cond_broadcast(&cond_trabajo);
+    pthread_mutex_unlock(&mutex);
+
+    for (size_t i = 0; i < hilos.size(); i++) {
+        pthread_join(hilos[i], nullptr);
+    }
+
+    pthread_mutex_destroy(&mutex_ejecucion);
+    pthread_cond_destroy(&cond_fin);
+    pthread_cond_destroy(&cond_trabajo);
+    pthread_mutex_destroy(&mutex);
+}
+
+void* ThreadPool::bucleTrabajador(void* arg) {
+    ArgTrabajador* datos = static_cast<ArgTrabajador*>(arg);
+    ThreadPool* pool = datos->pool;
+    hilo_del_pool = true;
+
+    unsigned long vista = 0;
+    while (true) {
+        // Dormir hasta que haya un trabajo nuevo o se pida terminar
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->terminar && pool->generacion == vista) {
+            pthread_cond_wait(&pool->cond_trabajo, &pool->mutex);
+        }
+        if (pool->terminar) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        vista = pool->generacion;
+        const std::function<void(int, int)>* func = pool->trabajo;
+        int total = pool->num_hilos;
+        pthread_mutex_unlock(&pool->mutex);
+
+        (*func)(datos->id, total);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pendientes == 0) {
+            pthread_cond_signal(&pool->cond_fin);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::ejecutar(const std::function<void(int, int)>& func) {
+    if (num_hilos == 1) {
+        func(0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&mutex_ejecucion);
+
+    pthread_mutex_lock(&mutex);
+    trabajo = &func;
+    pendientes = num_hilos - 1;
+    generacion++;
+    pthread_cond_broadcast(&cond_trabajo);
+    pthread_mutex_unlock(&mutex);
+
+    // El llamador trabaja como hilo 0; mientras tanto se marca como hilo del pool
+    // para que las llamadas anidadas se ejecuten en serie
+    bool anterior = hilo_del_pool;
+    hilo_del_pool = true;
+    func(0, num_hilos);
+    hilo_del_pool = anterior;
+
+    pthread_mutex_lock(&mutex);
+    while (pendientes > 0) {
+        pthread_cond_wait(&cond_fin, &mutex);
+    }
+    trabajo = nullptr;
+    pthread_mutex_unlock(&mutex);
+
+    pthread_mutex_unlock(&mutex_ejecucion);
+}
+
+bool ThreadPool::enHiloDelPool() {
+    return hilo_del_pool;
+}
+
+ThreadPool& ThreadPool::global() {
+    pthread_mutex_lock(&mutex_global);
+    if (pool_global == nullptr) {
+        pool_global = new ThreadPool(tamano_global > 0 ? tamano_global : detectarNumHilos());
+    }
+    ThreadPool* pool = pool_global;
+    pthread_mutex_unlock(&mutex_global);
+    return *pool;
+}
+
+void ThreadPool::configurarGlobal(int n) {
+    // Un trabajador no puede destruir el pool que lo está ejecutando
+    assert(!enHiloDelPool());
+
+    pthread_mutex_lock(&mutex_global);
+    tamano_global = (n > 0) ? n : 0;
+    int deseado = (tamano_global > 0) ? tamano_global : detectarNumHilos();
+    if (pool_global != nullptr && pool_global->getNumHilos() != deseado) {
+        delete pool_global;
+        pool_global = nullptr;
+    }
+    pthread_mutex_unlock(&mutex_global);
+}
+
+#ifdef __linux__
+// Cuota de CPU del cgroup (v2: cpu.max, v1: cpu.cfs_quota_us / cpu.cfs_period_us); 0 si no hay límite
+static int leerCuotaCgroup() {
+    long long cuota = -1, periodo = 0;
+
+    FILE* file = fopen("/sys/fs/cgroup/cpu.max", "r");
+    if (file != nullptr) {
+        char valor[32];
+        if (fscanf(file, "%31s %lld", valor, &periodo) == 2 && valor[0] != 'm') {
+            cuota = atoll(valor);
+        }
+        fclose(file);
+    } else {
+        file = fopen("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", "r");
+        if (file != nullptr) {
+            if (fscanf(file, "%lld", &cuota) != 1) {
+                cuota = -1;
+            }
+            fclose(file);
+        }
+        file = fopen("/sys/fs/cgroup/cpu/cpu.cfs_period_us", "r");
+        if (file != nullptr) {
+            if (fscanf(file, "%lld", &periodo) != 1) {
+                periodo = 0;
+            }
+            fclose(file);
+        }
+    }
+
+    if (cuota <= 0 || periodo <= 0) {
+        return 0;
+    }
+    // Redondear hacia arriba: una cuota de 1.5 CPUs permite 2 hilos ocupados a ratos
+    return static_cast<int>((cuota + periodo - 1) / periodo);
+}
+#endif
+
+int ThreadPool::detectarNumHilos() {
+    const char* env = getenv("FILTER_THREADS");
+    if (env != nullptr && atoi(env) > 0) {
+        return atoi(env);
+    }
+
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    int n = (hw > 0) ? hw : 1;
+
+#ifdef __linux__
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    if (sched_getaffinity(0, sizeof(conjunto), &conjunto) == 0 && CPU_COUNT(&conjunto) > 0) {
+        n = CPU_COUNT(&conjunto);
+    }
+
+    int cuota = leerCuotaCgroup();
+    if (cuota > 0 && cuota < n) {
+        n = cuota;
+    }
+#endif
+
+    return n;
+}
\ No newline at end of file
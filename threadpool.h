@@ -0,0 +1,67 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <functional>
+#include <vector>
+#include <pthread.h>
+
+// Pool persistente de hilos: los trabajadores se crean una vez y quedan dormidos
+// en una variable de condición entre trabajos, evitando pthread_create/join por ejecución
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_hilos);
+    ~ThreadPool();
+
+    int getNumHilos() const { return num_hilos; }
+
+    // Ejecutar func(id_hilo, num_hilos) en todos los hilos del pool y esperar a que terminen.
+    // El hilo llamador actúa como hilo 0.
+    void ejecutar(const std::function<void(int, int)>& func);
+
+    // Pool compartido por el motor de filtros (se crea en el primer uso; la creación está
+    // protegida, así que puede llamarse desde cualquier hilo)
+    static ThreadPool& global();
+
+    // Fijar el tamaño del pool global; n <= 0 vuelve a la detección automática.
+    // Si el tamaño cambia el pool se destruye y se recrea: solo debe llamarse desde el hilo
+    // principal, fuera del pool y sin otros hilos usándolo (p. ej. al procesar argumentos)
+    static void configurarGlobal(int n);
+
+    // Tamaño por defecto: variable FILTER_THREADS, cuota de CPU del cgroup,
+    // afinidad del proceso o número de núcleos, en ese orden
+    static int detectarNumHilos();
+
+    // true si el hilo actual es un trabajador del pool (para evitar anidamiento)
+    static bool enHiloDelPool();
+
+private:
+    struct ArgTrabajador {
+        ThreadPool* pool;
+        int id;
+    };
+
+    int num_hilos;
+    std::vector<pthread_t> hilos;
+    std::vector<ArgTrabajador> args;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_trabajo;
+    pthread_cond_t cond_fin;
+    pthread_mutex_t mutex_ejecucion;   // Serializa llamadas concurrentes a ejecutar()
+
+    const std::function<void(int, int)>* trabajo;
+    unsigned long generacion;
+    int pendientes;
+    bool terminar;
+
+    static ThreadPool* pool_global;
+    static int tamano_global;
+
+    static void* bucleTrabajador(void* arg);
+
+    // No copiable
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif
\ No newline at end of file